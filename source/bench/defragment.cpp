@@ -0,0 +1,148 @@
+/** defragment.cpp
+ * Measures list_partition traversal before and after defragmenting.
+ *
+ * Copyright © 2020 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <gch/partition/list_partition.hpp>
+#include <gch/partition/pool_alloc.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+  struct message
+  {
+    std::uint64_t id;
+    std::uint64_t payload[3];
+  };
+
+  template <typename Allocator>
+  using message_partition = gch::list_partition<message, 4, std::list<message, Allocator>>;
+
+  constexpr std::size_t element_count = 1 << 20;
+  constexpr int         passes        = 5;
+
+  using clock_type = std::chrono::steady_clock;
+
+  template <typename F>
+  double
+  best_ns_per_element (F f)
+  {
+    double best = 0;
+    for (int i = 0; i < passes; ++i)
+    {
+      const clock_type::time_point start = clock_type::now ();
+      f ();
+      const double ns =
+        std::chrono::duration<double, std::nano> (clock_type::now () - start).count ();
+      if (i == 0 || ns < best)
+        best = ns;
+    }
+    return best / static_cast<double> (element_count);
+  }
+
+  volatile std::uint64_t sink;
+
+  template <typename Allocator>
+  std::uint64_t
+  traverse (const message_partition<Allocator>& p)
+  {
+    std::uint64_t sum = 0;
+    for (const message& m : p.get_data_view ())
+      sum += m.id;
+    return sum;
+  }
+
+  // Builds the partition in order, then splices every element to the back of a random subrange
+  // in random order, so that neighbours in the list are far apart on the heap.
+  template <typename Allocator>
+  void
+  scramble (message_partition<Allocator>& p)
+  {
+    using iter = typename message_partition<Allocator>::data_iter;
+
+    std::vector<iter> nodes;
+    nodes.reserve (element_count);
+    for (iter it = p.data_begin (); it != p.data_end (); ++it)
+      nodes.push_back (it);
+
+    std::mt19937 rng (7);
+    std::shuffle (nodes.begin (), nodes.end (), rng);
+
+    auto& s0 = gch::get_subrange<0> (p);
+    auto& s1 = gch::get_subrange<1> (p);
+    auto& s2 = gch::get_subrange<2> (p);
+    auto& s3 = gch::get_subrange<3> (p);
+    std::size_t i = 0;
+    for (iter it : nodes)
+    {
+      switch (i++ % 4)
+      {
+        case 0:  s1.splice (s1.end (), s0, it); break;
+        case 1:  s2.splice (s2.end (), s0, it); break;
+        case 2:  s3.splice (s3.end (), s0, it); break;
+        default: s0.splice (s0.end (), s0, it); break;
+      }
+    }
+  }
+
+  template <typename Allocator>
+  void
+  run (const char *name)
+  {
+    message_partition<Allocator> p;
+    for (std::uint64_t i = 0; i < element_count; ++i)
+      gch::get_subrange<0> (p).push_back (message { i, { i, i, i } });
+
+    const double in_order = best_ns_per_element ([&p] (void) { sink = traverse (p); });
+
+    scramble (p);
+    const double scrambled = best_ns_per_element ([&p] (void) { sink = traverse (p); });
+
+    const clock_type::time_point start = clock_type::now ();
+    p.defragment ();
+    const double defrag_ms =
+      std::chrono::duration<double, std::milli> (clock_type::now () - start).count ();
+
+    const double defragmented = best_ns_per_element ([&p] (void) { sink = traverse (p); });
+
+    std::printf ("%-16s in order %6.2f ns/elem  scrambled %6.2f ns/elem  "
+                 "defragmented %6.2f ns/elem  (defragment took %7.2f ms)\n",
+                 name, in_order, scrambled, defragmented, defrag_ms);
+  }
+
+}
+
+int
+main (void)
+{
+  std::vector<message> v;
+  v.reserve (element_count);
+  for (std::uint64_t i = 0; i < element_count; ++i)
+    v.push_back (message { i, { i, i, i } });
+
+  const double vec = best_ns_per_element ([&v] (void)
+                                          {
+                                            std::uint64_t sum = 0;
+                                            for (const message& m : v)
+                                              sum += m.id;
+                                            sink = sum;
+                                          });
+  std::printf ("%-16s %6.2f ns/elem\n", "std::vector", vec);
+
+  run<std::allocator<message>> ("std::allocator");
+  run<gch::pool_alloc<message>> ("gch::pool_alloc");
+  return 0;
+}
@@ -0,0 +1,84 @@
+/** epoch_update.cpp
+ * Measures what an epoch_partition update costs as the partition grows.
+ *
+ * Copyright © 2020 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <gch/partition/epoch_partition.hpp>
+#include <gch/partition/list_partition.hpp>
+#include <gch/partition/vector_partition.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+
+namespace
+{
+
+  constexpr std::size_t copied_elements = 1 << 22;
+  constexpr std::size_t max_size        = 1 << 18;
+
+  using clock_type = std::chrono::steady_clock;
+
+  double
+  elapsed_ns (clock_type::time_point start)
+  {
+    return std::chrono::duration<double, std::nano> (clock_type::now () - start).count ();
+  }
+
+  template <typename Partition>
+  Partition
+  make_partition (std::size_t size)
+  {
+    Partition p;
+    for (std::size_t i = 0; i < size; ++i)
+      gch::get_subrange<0> (p).push_back (i);
+    return p;
+  }
+
+  // Changes one element per update, so the time is all copying and publishing.
+  template <typename Partition>
+  void
+  run (const char *name)
+  {
+    std::printf ("%s\n", name);
+    for (std::size_t size = 64; size <= max_size; size *= 4)
+    {
+      const std::size_t updates = std::max (copied_elements / size, std::size_t (16));
+
+      gch::epoch_partition<Partition> e (make_partition<Partition> (size));
+      clock_type::time_point start = clock_type::now ();
+      for (std::size_t i = 0; i < updates; ++i)
+        e.update ([] (Partition& p) { ++*gch::get_subrange<0> (p).begin (); });
+      const double update_ns = elapsed_ns (start) / static_cast<double> (updates);
+
+      // the same change in place under a mutex, for scale
+      Partition  locked (make_partition<Partition> (size));
+      std::mutex mutex;
+      start = clock_type::now ();
+      for (std::size_t i = 0; i < updates; ++i)
+      {
+        std::lock_guard<std::mutex> lock (mutex);
+        ++*gch::get_subrange<0> (locked).begin ();
+      }
+      const double locked_ns = elapsed_ns (start) / static_cast<double> (updates);
+
+      std::printf ("  %7zu elements  update %11.0f ns (%5.2f ns/elem)  in place %5.0f ns\n",
+                   size, update_ns, update_ns / static_cast<double> (size), locked_ns);
+    }
+  }
+
+}
+
+int
+main (void)
+{
+  run<gch::vector_partition<std::uint64_t, 4>> ("vector_partition<std::uint64_t, 4>");
+  run<gch::list_partition<std::uint64_t, 4>> ("list_partition<std::uint64_t, 4>");
+  return 0;
+}
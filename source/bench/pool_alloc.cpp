@@ -0,0 +1,170 @@
+/** pool_alloc.cpp
+ * Compares list_partition with std::allocator and with pool_alloc.
+ *
+ * Copyright © 2020 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#include <gch/partition/list_partition.hpp>
+#include <gch/partition/pool_alloc.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+  struct message
+  {
+    std::uint64_t id;
+    std::uint64_t payload[3];
+  };
+
+  template <typename Allocator>
+  using message_partition = gch::list_partition<message, 4, std::list<message, Allocator>>;
+
+  constexpr std::size_t partition_count = 2000;
+  constexpr std::size_t initial_size    = 32;
+  constexpr std::size_t rounds          = 200;
+  constexpr std::size_t thread_count    = 4;
+
+  class xorshift
+  {
+  public:
+    std::uint64_t
+    operator() (void) noexcept
+    {
+      m_state ^= m_state << 13;
+      m_state ^= m_state >> 7;
+      m_state ^= m_state << 17;
+      return m_state;
+    }
+
+  private:
+    std::uint64_t m_state = 0x9E3779B97F4A7C15ULL;
+  };
+
+  using clock_type = std::chrono::steady_clock;
+
+  double
+  elapsed_ns (clock_type::time_point start)
+  {
+    return std::chrono::duration<double, std::nano> (clock_type::now () - start).count ();
+  }
+
+  // Messages arrive in subrange 0, move through subranges 1 and 2, and leave from subrange 3.
+  // The partitions are visited in random order so that their nodes are interleaved on the heap.
+  template <typename Allocator>
+  std::size_t
+  churn (std::vector<message_partition<Allocator>>& partitions, std::size_t n_rounds)
+  {
+    xorshift      rng;
+    std::size_t   ops = 0;
+    std::uint64_t id  = 0;
+    for (std::size_t r = 0; r < n_rounds * partitions.size (); ++r)
+    {
+      auto& p = partitions[rng () % partitions.size ()];
+      auto& s0 = gch::get_subrange<0> (p);
+      auto& s1 = gch::get_subrange<1> (p);
+      auto& s2 = gch::get_subrange<2> (p);
+      auto& s3 = gch::get_subrange<3> (p);
+
+      s0.push_back (message { ++id, { id, id, id } });
+      s1.splice (s1.end (), s0, s0.begin ());
+      s2.splice (s2.end (), s1, s1.begin ());
+      s3.splice (s3.end (), s2, s2.begin ());
+      s3.pop_front ();
+      ops += 5;
+    }
+    return ops;
+  }
+
+  template <typename Allocator>
+  std::uint64_t
+  traverse (const std::vector<message_partition<Allocator>>& partitions)
+  {
+    std::uint64_t sum = 0;
+    for (const auto& p : partitions)
+      for (const message& m : gch::get_subrange<3> (p))
+        sum += m.id;
+    return sum;
+  }
+
+  template <typename Allocator>
+  std::vector<message_partition<Allocator>>
+  make_partitions (void)
+  {
+    std::vector<message_partition<Allocator>> partitions (partition_count);
+    for (std::size_t i = 0; i < initial_size; ++i)
+    {
+      for (auto& p : partitions)
+      {
+        gch::get_subrange<1> (p).push_back (message { i, { i, i, i } });
+        gch::get_subrange<2> (p).push_back (message { i, { i, i, i } });
+        gch::get_subrange<3> (p).push_back (message { i, { i, i, i } });
+      }
+    }
+    return partitions;
+  }
+
+  template <typename Allocator>
+  void
+  run (const char *name)
+  {
+    clock_type::time_point start = clock_type::now ();
+    std::vector<message_partition<Allocator>> partitions = make_partitions<Allocator> ();
+    const double build_ns = elapsed_ns (start);
+
+    start = clock_type::now ();
+    const std::size_t ops = churn (partitions, rounds);
+    const double churn_ns = elapsed_ns (start);
+
+    start = clock_type::now ();
+    const std::uint64_t sum = traverse (partitions);
+    const double traverse_ns = elapsed_ns (start);
+
+    start = clock_type::now ();
+    partitions.clear ();
+    const double destroy_ns = elapsed_ns (start);
+
+    // every thread churns its own partitions, as a server with one partition set per worker would
+    start = clock_type::now ();
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < thread_count; ++t)
+    {
+      threads.emplace_back ([] (void)
+                            {
+                              auto local = make_partitions<Allocator> ();
+                              churn (local, rounds / thread_count);
+                            });
+    }
+    for (std::thread& t : threads)
+      t.join ();
+    const double threaded_ns = elapsed_ns (start);
+
+    std::printf ("%-16s build %8.2f ms  churn %6.2f ns/op  traverse %8.2f ms  "
+                 "destroy %8.2f ms  %zu threads %8.2f ms  (checksum %llu)\n",
+                 name, build_ns / 1e6, churn_ns / static_cast<double> (ops), traverse_ns / 1e6,
+                 destroy_ns / 1e6, thread_count, threaded_ns / 1e6,
+                 static_cast<unsigned long long> (sum));
+  }
+
+}
+
+int
+main (void)
+{
+  for (int i = 0; i < 2; ++i)
+  {
+    run<std::allocator<message>> ("std::allocator");
+    run<gch::pool_alloc<message>> ("gch::pool_alloc");
+  }
+  return 0;
+}
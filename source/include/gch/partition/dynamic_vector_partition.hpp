@@ -0,0 +1,667 @@
+/** dynamic_vector_partition.hpp
+ * Short description here.
+ *
+ * Copyright © 2020 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef PARTITION_DYNAMIC_VECTOR_PARTITION_HPP
+#define PARTITION_DYNAMIC_VECTOR_PARTITION_HPP
+
+#include "partition.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+namespace gch
+{
+
+  // A vector partition where the number of subranges is chosen at runtime. Subranges can be
+  // added, removed, split and merged; splitting and merging only move boundaries.
+  template <typename T, typename Container = std::vector<T>>
+  class dynamic_vector_partition;
+
+  // A reference to subrange `index ()` of a `dynamic_vector_partition`. It refers to whichever
+  // subrange has that index, so it does not follow a subrange when subranges are inserted or
+  // erased before it.
+  template <typename Partition>
+  class dynamic_subrange
+  {
+  public:
+    using partition_type          = Partition;
+    using nonconst_partition_type = typename std::remove_const<Partition>::type;
+
+    using container_type  = typename nonconst_partition_type::container_type;
+    using iterator        = typename std::conditional<std::is_const<Partition>::value,
+                                                      typename container_type::const_iterator,
+                                                      typename container_type::iterator>::type;
+    using const_iterator  = typename container_type::const_iterator;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using reference       = typename std::iterator_traits<iterator>::reference;
+    using const_reference = typename container_type::const_reference;
+    using size_type       = typename container_type::size_type;
+    using difference_type = typename container_type::difference_type;
+    using value_type      = typename container_type::value_type;
+
+  private:
+    using iter     = iterator;
+    using citer    = const_iterator;
+    using riter    = reverse_iterator;
+    using criter   = const_reverse_iterator;
+    using ref      = reference;
+    using cref     = const_reference;
+    using size_ty  = size_type;
+    using diff_ty  = difference_type;
+    using value_ty = value_type;
+
+  public:
+    dynamic_subrange            (void)                        = delete;
+    dynamic_subrange            (const dynamic_subrange&)     = default;
+    dynamic_subrange            (dynamic_subrange&&) noexcept = default;
+    dynamic_subrange& operator= (const dynamic_subrange&)     = default;
+    dynamic_subrange& operator= (dynamic_subrange&&) noexcept = default;
+    ~dynamic_subrange           (void)                        = default;
+
+    dynamic_subrange (partition_type& p, std::size_t index) noexcept
+      : m_partition (&p),
+        m_index     (index)
+    { }
+
+    // conversion to a reference to a const partition
+    template <typename NonConst,
+              typename = typename std::enable_if<std::is_same<nonconst_partition_type,
+                                                              NonConst>::value>::type>
+    /* implicit */ dynamic_subrange (const dynamic_subrange<NonConst>& other) noexcept
+      : m_partition (&other.get_partition ()),
+        m_index     (other.index ())
+    { }
+
+    GCH_NODISCARD partition_type& get_partition (void) const noexcept { return *m_partition; }
+    GCH_NODISCARD std::size_t     index         (void) const noexcept { return m_index;      }
+
+    GCH_NODISCARD iter   begin   (void) const noexcept { return m_partition->subrange_iter (m_index);      }
+    GCH_NODISCARD citer  cbegin  (void) const noexcept { return m_partition->subrange_iter (m_index);      }
+
+    GCH_NODISCARD iter   end     (void) const noexcept { return m_partition->subrange_iter (m_index + 1);  }
+    GCH_NODISCARD citer  cend    (void) const noexcept { return m_partition->subrange_iter (m_index + 1);  }
+
+    GCH_NODISCARD riter  rbegin  (void) const noexcept { return riter (end ());                            }
+    GCH_NODISCARD criter crbegin (void) const noexcept { return criter (cend ());                          }
+
+    GCH_NODISCARD riter  rend    (void) const noexcept { return riter (begin ());                          }
+    GCH_NODISCARD criter crend   (void) const noexcept { return criter (cbegin ());                        }
+
+    GCH_NODISCARD ref    front   (void) const noexcept { return *begin ();                                 }
+    GCH_NODISCARD ref    back    (void) const noexcept { return *(--end ());                               }
+
+    GCH_NODISCARD
+    size_ty
+    size (void) const noexcept
+    {
+      return static_cast<size_ty> (m_partition->get_offset (m_index + 1)
+                                   - m_partition->get_offset (m_index));
+    }
+
+    GCH_NODISCARD
+    bool
+    empty (void) const noexcept
+    {
+      return size () == 0;
+    }
+
+    subrange_view<iter>
+    view (void) const
+    {
+      return { begin (), end () };
+    }
+
+    void clear (void) const
+    {
+      erase (cbegin (), cend ());
+    }
+
+    iter insert (const citer pos, const value_ty& lv) const
+    {
+      return m_partition->subrange_insert (m_index, pos, lv);
+    }
+
+    iter insert (const citer pos, value_ty&& rv) const
+    {
+      return m_partition->subrange_insert (m_index, pos, std::move (rv));
+    }
+
+    iter insert (const citer pos, size_ty count, const value_ty& val) const
+    {
+      return m_partition->subrange_insert (m_index, pos, count, val);
+    }
+
+    template <typename Iterator>
+    iter insert (const citer pos, Iterator first, Iterator last) const
+    {
+      return m_partition->subrange_insert (m_index, pos, first, last);
+    }
+
+    iter insert (const citer pos, std::initializer_list<value_ty> ilist) const
+    {
+      return m_partition->subrange_insert (m_index, pos, ilist);
+    }
+
+    template <typename ...Args>
+    iter emplace (const citer pos, Args&&... args) const
+    {
+      return m_partition->subrange_emplace (m_index, pos, std::forward<Args> (args)...);
+    }
+
+    iter erase (const citer pos) const
+    {
+      return m_partition->subrange_erase (m_index, pos, std::next (pos));
+    }
+
+    iter erase (const citer first, const citer last) const
+    {
+      return m_partition->subrange_erase (m_index, first, last);
+    }
+
+    void push_back (const value_ty& val) const
+    {
+      insert (cend (), val);
+    }
+
+    void push_back (value_ty&& val) const
+    {
+      insert (cend (), std::move (val));
+    }
+
+    template <typename ...Args>
+    ref emplace_back (Args&&... args) const
+    {
+      return *emplace (cend (), std::forward<Args> (args)...);
+    }
+
+    void pop_back (void) const
+    {
+      erase (--cend ());
+    }
+
+    void resize (size_ty count) const
+    {
+      resize (count, { });
+    }
+
+    void resize (size_ty count, const value_ty& val) const
+    {
+      if (count > size ())
+        insert (cend (), count - size (), val);
+      else if (count < size ())
+        erase (std::next (cbegin (), static_cast<diff_ty> (count)), cend ());
+    }
+
+    // The unordered operations do not preserve the order of elements in this subrange or any of
+    // the following subranges. In exchange, they only move one element per following subrange.
+
+    void unordered_push_back (const value_ty& val) const
+    {
+      m_partition->subrange_unordered_emplace_back (m_index, val);
+    }
+
+    void unordered_push_back (value_ty&& val) const
+    {
+      m_partition->subrange_unordered_emplace_back (m_index, std::move (val));
+    }
+
+    template <typename ...Args>
+    ref unordered_emplace_back (Args&&... args) const
+    {
+      return *m_partition->subrange_unordered_emplace_back (m_index, std::forward<Args> (args)...);
+    }
+
+    iter unordered_erase (const citer pos) const
+    {
+      return m_partition->subrange_unordered_erase (m_index, pos);
+    }
+
+    // Moves the element at `pos` into `dest` by exchanging it with the elements at the
+    // boundaries in between. It lands at the front of `dest` if `dest` comes after this
+    // subrange, and at the back otherwise.
+    iter transfer (const citer pos, const dynamic_subrange& dest) const
+    {
+      if (dest.m_partition != m_partition)
+        throw std::invalid_argument ("the subranges belong to different partitions");
+      return m_partition->subrange_transfer (m_index, pos, dest.index ());
+    }
+
+    iter advance_begin (diff_ty change) const
+    {
+      return m_partition->advance_begin (m_index, change);
+    }
+
+    iter advance_end (diff_ty change) const
+    {
+      return m_partition->advance_end (m_index, change);
+    }
+
+  private:
+    partition_type *m_partition;
+    std::size_t     m_index;
+  };
+
+  template <typename T, typename Container>
+  class dynamic_vector_partition
+  {
+    template <typename>
+    friend class dynamic_subrange;
+
+  public:
+    using container_type = Container;
+
+    using data_iter    = typename container_type::iterator;
+    using data_citer   = typename container_type::const_iterator;
+    using data_riter   = typename container_type::reverse_iterator;
+    using data_criter  = typename container_type::const_reverse_iterator;
+    using data_ref     = typename container_type::reference;
+    using data_cref    = typename container_type::const_reference;
+    using data_size_t  = typename container_type::size_type;
+    using data_diff_t  = typename container_type::difference_type;
+    using data_val_t   = typename container_type::value_type;
+    using data_alloc_t = typename container_type::allocator_type;
+
+    using subrange_type       = dynamic_subrange<dynamic_vector_partition>;
+    using const_subrange_type = dynamic_subrange<const dynamic_vector_partition>;
+
+    using subrange_view_type       = subrange_view<data_iter>;
+    using const_subrange_view_type = subrange_view<data_citer>;
+
+  private:
+    using offset_container = std::vector<data_diff_t>;
+
+  public:
+    dynamic_vector_partition            (void)                                = default;
+    dynamic_vector_partition            (const dynamic_vector_partition&)     = default;
+    dynamic_vector_partition            (dynamic_vector_partition&&) noexcept = default;
+    dynamic_vector_partition& operator= (const dynamic_vector_partition&)     = default;
+    dynamic_vector_partition& operator= (dynamic_vector_partition&&) noexcept = default;
+    ~dynamic_vector_partition           (void)                                = default;
+
+    explicit dynamic_vector_partition (const data_alloc_t& alloc)
+      : m_container (alloc)
+    { }
+
+    // creates `count` empty subranges
+    explicit dynamic_vector_partition (std::size_t count, const data_alloc_t& alloc = data_alloc_t ())
+      : m_container (alloc),
+        m_offsets   (count, 0)
+    { }
+
+    GCH_NODISCARD std::size_t size  (void) const noexcept { return m_offsets.size ();  }
+    GCH_NODISCARD bool        empty (void) const noexcept { return m_offsets.empty (); }
+
+    GCH_NODISCARD
+    subrange_type
+    operator[] (std::size_t idx) noexcept
+    {
+      return { *this, idx };
+    }
+
+    GCH_NODISCARD
+    const_subrange_type
+    operator[] (std::size_t idx) const noexcept
+    {
+      return { *this, idx };
+    }
+
+    GCH_NODISCARD
+    subrange_type
+    at (std::size_t idx)
+    {
+      check_index (idx);
+      return { *this, idx };
+    }
+
+    GCH_NODISCARD
+    const_subrange_type
+    at (std::size_t idx) const
+    {
+      check_index (idx);
+      return { *this, idx };
+    }
+
+    GCH_NODISCARD subrange_type       front (void)       noexcept { return { *this, 0 };          }
+    GCH_NODISCARD const_subrange_type front (void) const noexcept { return { *this, 0 };          }
+
+    GCH_NODISCARD subrange_type       back  (void)       noexcept { return { *this, size () - 1 }; }
+    GCH_NODISCARD const_subrange_type back  (void) const noexcept { return { *this, size () - 1 }; }
+
+    data_iter   data_begin   (void)       noexcept { return m_container.begin ();   }
+    data_citer  data_begin   (void) const noexcept { return m_container.begin ();   }
+    data_citer  data_cbegin  (void) const noexcept { return m_container.cbegin ();  }
+
+    data_iter   data_end     (void)       noexcept { return m_container.end ();     }
+    data_citer  data_end     (void) const noexcept { return m_container.end ();     }
+    data_citer  data_cend    (void) const noexcept { return m_container.cend ();    }
+
+    data_riter  data_rbegin  (void)       noexcept { return m_container.rbegin ();  }
+    data_criter data_rbegin  (void) const noexcept { return m_container.rbegin ();  }
+    data_criter data_crbegin (void) const noexcept { return m_container.crbegin (); }
+
+    data_riter  data_rend    (void)       noexcept { return m_container.rend ();    }
+    data_criter data_rend    (void) const noexcept { return m_container.rend ();    }
+    data_criter data_crend   (void) const noexcept { return m_container.crend ();   }
+
+    data_size_t data_size (void) const noexcept { return m_container.size (); }
+    GCH_NODISCARD bool data_empty (void) const noexcept { return m_container.empty (); }
+
+    void reserve (data_size_t new_cap)
+    {
+      m_container.reserve (new_cap);
+    }
+
+    data_alloc_t get_allocator (void) const noexcept
+    {
+      return m_container.get_allocator ();
+    }
+
+    // Returns the index of the subrange containing `pos` in O(log N). Where several subranges
+    // begin at `pos` (i.e. some of them are empty), the last one is returned. If there are no
+    // subranges, returns `size ()`.
+    GCH_NODISCARD
+    std::size_t
+    find_subrange (data_citer pos) const noexcept
+    {
+      const data_diff_t off = std::distance (m_container.cbegin (), pos);
+      const auto it = std::upper_bound (m_offsets.begin (), m_offsets.end (), off);
+      if (it == m_offsets.begin ())
+        return size ();
+      return static_cast<std::size_t> (it - m_offsets.begin ()) - 1;
+    }
+
+    // inserts an empty subrange before subrange `idx`
+    subrange_type
+    insert_subrange (std::size_t idx)
+    {
+      if (idx > size ())
+        throw std::out_of_range ("subrange index is out of range");
+
+      m_offsets.insert (std::next (m_offsets.begin (), static_cast<data_diff_t> (idx)),
+                        get_offset (idx));
+      return { *this, idx };
+    }
+
+    subrange_type
+    push_back_subrange (void)
+    {
+      return insert_subrange (size ());
+    }
+
+    // erases subrange `idx` along with its elements
+    void
+    erase_subrange (std::size_t idx)
+    {
+      check_index (idx);
+      subrange_erase (idx, subrange_iter (idx), subrange_iter (idx + 1));
+      m_offsets.erase (std::next (m_offsets.begin (), static_cast<data_diff_t> (idx)));
+    }
+
+    // Splits subrange `idx` at `pos`. The elements from `pos` onward become subrange `idx + 1`.
+    subrange_type
+    split_subrange (std::size_t idx, data_citer pos)
+    {
+      check_index (idx);
+      const data_diff_t off = std::distance (m_container.cbegin (), pos);
+      if (off < get_offset (idx) || get_offset (idx + 1) < off)
+        throw std::out_of_range ("split position is not in the subrange");
+
+      m_offsets.insert (std::next (m_offsets.begin (), static_cast<data_diff_t> (idx + 1)), off);
+      return { *this, idx + 1 };
+    }
+
+    // merges the subranges in [first, last] into subrange `first`
+    subrange_type
+    merge_subranges (std::size_t first, std::size_t last)
+    {
+      check_index (last);
+      if (last < first)
+        throw std::out_of_range ("subrange index is out of range");
+
+      m_offsets.erase (std::next (m_offsets.begin (), static_cast<data_diff_t> (first + 1)),
+                       std::next (m_offsets.begin (), static_cast<data_diff_t> (last + 1)));
+      return { *this, first };
+    }
+
+    // Same semantics as `vector_partition`. Moving a boundary past other boundaries pushes them
+    // along with it.
+    data_iter
+    advance_begin (std::size_t idx, data_diff_t change)
+    {
+      if (idx == 0)
+        throw std::out_of_range ("the beginning of the first subrange cannot be moved");
+      check_index (idx);
+
+      data_diff_t& offset = m_offsets[idx];
+
+      // first case: past end, second case: past begin
+      if (((change > 0) && (change > static_cast<data_diff_t> (m_container.size ()) - offset))
+          || ((change < 0) && (-change > offset)))
+        throw std::out_of_range ("requested change of subrange offset is out of range");
+
+      offset += change;
+      for (std::size_t i = idx + 1; i < size () && m_offsets[i] < offset; ++i)
+        m_offsets[i] = offset;
+
+      for (std::size_t i = idx - 1; 0 < i && offset < m_offsets[i]; --i)
+        m_offsets[i] = offset;
+
+      return subrange_iter (idx);
+    }
+
+    data_iter
+    advance_end (std::size_t idx, data_diff_t change)
+    {
+      return advance_begin (idx + 1, change);
+    }
+
+    subrange_view_type
+    get_subrange_view (std::size_t idx)
+    {
+      return { subrange_iter (idx), subrange_iter (idx + 1) };
+    }
+
+    const_subrange_view_type
+    get_subrange_view (std::size_t idx) const
+    {
+      return { subrange_iter (idx), subrange_iter (idx + 1) };
+    }
+
+    std::vector<subrange_view_type>
+    get_partition_view (void)
+    {
+      std::vector<subrange_view_type> ret;
+      ret.reserve (size ());
+      for (std::size_t i = 0; i < size (); ++i)
+        ret.push_back (get_subrange_view (i));
+      return ret;
+    }
+
+    std::vector<const_subrange_view_type>
+    get_partition_view (void) const
+    {
+      std::vector<const_subrange_view_type> ret;
+      ret.reserve (size ());
+      for (std::size_t i = 0; i < size (); ++i)
+        ret.push_back (get_subrange_view (i));
+      return ret;
+    }
+
+    void
+    swap (dynamic_vector_partition& other) noexcept
+    {
+      using std::swap;
+      swap (m_container, other.m_container);
+      swap (m_offsets, other.m_offsets);
+    }
+
+  private:
+    void
+    check_index (std::size_t idx) const
+    {
+      if (idx >= size ())
+        throw std::out_of_range ("subrange index is out of range");
+    }
+
+    // subrange `size ()` begins at the end of the container
+    data_diff_t
+    get_offset (std::size_t idx) const noexcept
+    {
+      return idx < size () ? m_offsets[idx] : static_cast<data_diff_t> (m_container.size ());
+    }
+
+    data_iter  subrange_iter (std::size_t idx)       noexcept { return std::next (m_container.begin (), get_offset (idx));  }
+    data_citer subrange_iter (std::size_t idx) const noexcept { return std::next (m_container.cbegin (), get_offset (idx)); }
+
+    void
+    add_to_offsets (std::size_t first, data_diff_t change) noexcept
+    {
+      for (std::size_t i = first; i < size (); ++i)
+        m_offsets[i] += change;
+    }
+
+    template <typename ...Args>
+    data_iter
+    subrange_insert (std::size_t idx, data_citer pos, Args&&... args)
+    {
+      const data_size_t old_size = m_container.size ();
+      data_iter ret = m_container.insert (pos, std::forward<Args> (args)...);
+      add_to_offsets (idx + 1, static_cast<data_diff_t> (m_container.size () - old_size));
+      return ret;
+    }
+
+    template <typename ...Args>
+    data_iter
+    subrange_emplace (std::size_t idx, data_citer pos, Args&&... args)
+    {
+      data_iter ret = m_container.emplace (pos, std::forward<Args> (args)...);
+      add_to_offsets (idx + 1, 1);
+      return ret;
+    }
+
+    data_iter
+    subrange_erase (std::size_t idx, data_citer first, data_citer last)
+    {
+      const data_diff_t change = std::distance (last, first); // <= 0
+      data_iter ret = m_container.erase (first, last);
+      add_to_offsets (idx + 1, change);
+      return ret;
+    }
+
+    template <typename ...Args>
+    data_iter
+    subrange_unordered_emplace_back (std::size_t idx, Args&&... args)
+    {
+      m_container.emplace_back (std::forward<Args> (args)...);
+      cycle_back_left (idx);
+      return std::prev (subrange_iter (idx + 1));
+    }
+
+    data_iter
+    subrange_unordered_erase (std::size_t idx, data_citer pos)
+    {
+      const data_diff_t off = std::distance (m_container.cbegin (), pos);
+      const data_iter   it  = std::next (m_container.begin (), off);
+      const data_iter   lst = std::prev (subrange_iter (idx + 1));
+      if (it != lst)
+        std::iter_swap (it, lst);
+      cycle_hole_right (idx);
+      return std::next (m_container.begin (), off);
+    }
+
+    data_iter
+    subrange_transfer (std::size_t idx, data_citer pos, std::size_t dest)
+    {
+      const data_iter it = std::next (m_container.begin (),
+                                      std::distance (m_container.cbegin (), pos));
+      if (idx < dest)
+        return pass_right (idx, dest, it);
+      if (dest < idx)
+        return pass_left (idx, dest, it);
+      return it;
+    }
+
+    // Moves the element at the back of the container to the end of subrange `idx` by exchanging
+    // it with the first element of every subrange in between.
+    void
+    cycle_back_left (std::size_t idx)
+    {
+      for (std::size_t i = size () - 1; idx < i; --i)
+      {
+        const data_diff_t pos = get_offset (i + 1) - 1;
+        if (pos != m_offsets[i])
+          std::iter_swap (std::next (m_container.begin (), m_offsets[i]),
+                          std::next (m_container.begin (), pos));
+        ++m_offsets[i];
+      }
+    }
+
+    // The inverse of the above. The element at the end of subrange `idx` is carried to the back
+    // of the container and popped.
+    void
+    cycle_hole_right (std::size_t idx)
+    {
+      for (std::size_t i = idx + 1; i < size (); ++i)
+      {
+        --m_offsets[i];
+        const data_diff_t pos = get_offset (i + 1) - 1;
+        if (pos != m_offsets[i])
+          std::iter_swap (std::next (m_container.begin (), m_offsets[i]),
+                          std::next (m_container.begin (), pos));
+      }
+      m_container.pop_back ();
+    }
+
+    // Carries the element at `it` in subrange `idx` into the front of subrange `dest`.
+    data_iter
+    pass_right (std::size_t idx, std::size_t dest, data_iter it)
+    {
+      for (std::size_t i = idx; i < dest; ++i)
+      {
+        const data_iter last = std::next (m_container.begin (), get_offset (i + 1) - 1);
+        if (it != last)
+          std::iter_swap (it, last);
+        --m_offsets[i + 1];
+        it = last;
+      }
+      return it;
+    }
+
+    // Carries the element at `it` in subrange `idx` into the back of subrange `dest`.
+    data_iter
+    pass_left (std::size_t idx, std::size_t dest, data_iter it)
+    {
+      for (std::size_t i = idx; dest < i; --i)
+      {
+        const data_iter first = std::next (m_container.begin (), m_offsets[i]);
+        if (it != first)
+          std::iter_swap (it, first);
+        ++m_offsets[i];
+        it = first;
+      }
+      return it;
+    }
+
+    container_type   m_container;
+    offset_container m_offsets;
+  };
+
+  template <typename T, typename Container>
+  void swap (dynamic_vector_partition<T, Container>& lhs,
+             dynamic_vector_partition<T, Container>& rhs) noexcept
+  {
+    lhs.swap (rhs);
+  }
+
+}
+
+#endif // PARTITION_DYNAMIC_VECTOR_PARTITION_HPP
@@ -0,0 +1,214 @@
+/** epoch_partition.hpp
+ * Short description here.
+ *
+ * Copyright © 2020 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef PARTITION_EPOCH_PARTITION_HPP
+#define PARTITION_EPOCH_PARTITION_HPP
+
+#include "partition.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace gch
+{
+
+  // Lets readers traverse a partition without locks while a writer changes it (read-copy-update).
+  //
+  // The writer never touches a version that readers can see. It copies the current version,
+  // changes the copy, and publishes it. The old version is retired with the current epoch, and is
+  // only destroyed once every reader that pinned an epoch up to and including that one is done.
+  // Readers pin an epoch in one of a fixed number of slots, then traverse the published version
+  // through its ordinary const interface (`get_subrange<I> (p).view ()` and so on).
+  //
+  // Every `update` copies the whole partition, so a write is O(n) in time and needs memory for a
+  // second copy, plus any retired versions readers still hold. This is meant for read-heavy data
+  // of bounded size. `bench/epoch_update.cpp` measures it: a `vector_partition` of trivially
+  // copyable elements costs well under a nanosecond per element, but a `list_partition` pays an
+  // allocation per node, around 50 ns per element, so 1000 elements already cost about 50 us per
+  // update. Keep list partitions to around a thousand elements, and batch changes into one
+  // `update` instead of making many small ones.
+  template <typename Partition>
+  class epoch_partition
+  {
+  public:
+    using partition_type = Partition;
+
+  private:
+    static constexpr std::size_t idle = 0;
+
+    // one reader slot per cache line
+    struct alignas (64) reader_slot
+    {
+      std::atomic<std::size_t> epoch { idle };
+    };
+
+    struct retired_version
+    {
+      std::size_t                     epoch;
+      std::unique_ptr<partition_type> version;
+    };
+
+  public:
+    // Keeps the version it was created with alive until it is destroyed.
+    class read_guard
+    {
+    public:
+      read_guard            (void)                  = delete;
+      read_guard            (const read_guard&)     = delete;
+      read_guard& operator= (const read_guard&)     = delete;
+      read_guard& operator= (read_guard&&) noexcept = delete;
+
+      read_guard (read_guard&& other) noexcept
+        : m_slot (other.m_slot),
+          m_version (other.m_version)
+      {
+        other.m_slot = nullptr;
+      }
+
+      ~read_guard (void)
+      {
+        if (m_slot != nullptr)
+          m_slot->epoch.store (idle, std::memory_order_release);
+      }
+
+      GCH_NODISCARD const partition_type& operator*  (void) const noexcept { return *m_version; }
+      GCH_NODISCARD const partition_type* operator-> (void) const noexcept { return m_version;  }
+      GCH_NODISCARD const partition_type* get        (void) const noexcept { return m_version;  }
+
+    private:
+      friend class epoch_partition;
+
+      read_guard (reader_slot& slot, const partition_type *version) noexcept
+        : m_slot (&slot),
+          m_version (version)
+      { }
+
+      reader_slot          *m_slot;
+      const partition_type *m_version;
+    };
+
+    epoch_partition            (const epoch_partition&)     = delete;
+    epoch_partition            (epoch_partition&&) noexcept = delete;
+    epoch_partition& operator= (const epoch_partition&)     = delete;
+    epoch_partition& operator= (epoch_partition&&) noexcept = delete;
+
+    // `max_readers` is the number of readers that may be pinned at the same time; any more will
+    // wait for a slot.
+    explicit epoch_partition (partition_type p = partition_type (),
+                              std::size_t max_readers = default_max_readers ())
+      : m_current (new partition_type (std::move (p))),
+        m_slots (std::max (max_readers, std::size_t (1)))
+    { }
+
+    ~epoch_partition (void)
+    {
+      delete m_current.load (std::memory_order_relaxed);
+    }
+
+    // Pins the current epoch and returns a guard for the current version. Lock-free unless every
+    // reader slot is in use.
+    GCH_NODISCARD
+    read_guard
+    pin (void) const
+    {
+      const std::size_t epoch = m_epoch.load ();
+      while (true)
+      {
+        for (reader_slot& slot : m_slots)
+        {
+          std::size_t expected = idle;
+          if (slot.epoch.compare_exchange_strong (expected, epoch))
+            return read_guard (slot, m_current.load ());
+        }
+        std::this_thread::yield ();
+      }
+    }
+
+    // Calls `f (partition)` on the current version without locking.
+    template <typename F>
+    auto
+    read (F f) const
+      -> decltype (f (std::declval<const partition_type&> ()))
+    {
+      const read_guard guard (pin ());
+      return f (*guard);
+    }
+
+    // Calls `f (partition)` on a copy of the current version and publishes the copy. Writers are
+    // serialized with each other, but never wait on readers.
+    template <typename F>
+    void
+    update (F f)
+    {
+      std::lock_guard<std::mutex> lock (m_write_mutex);
+
+      std::unique_ptr<partition_type> next (
+        new partition_type (*m_current.load (std::memory_order_relaxed)));
+      f (*next);
+
+      std::unique_ptr<partition_type> prev (m_current.exchange (next.release ()));
+      m_retired.push_back (retired_version { m_epoch.fetch_add (1), std::move (prev) });
+      reclaim_retired ();
+    }
+
+    // Destroys any retired versions that no reader can still see, and returns how many remain.
+    std::size_t
+    reclaim (void)
+    {
+      std::lock_guard<std::mutex> lock (m_write_mutex);
+      return reclaim_retired ();
+    }
+
+  private:
+    static std::size_t
+    default_max_readers (void) noexcept
+    {
+      return std::max (2 * std::thread::hardware_concurrency (), 8U);
+    }
+
+    std::size_t
+    reclaim_retired (void)
+    {
+      std::size_t oldest = std::numeric_limits<std::size_t>::max ();
+      for (const reader_slot& slot : m_slots)
+      {
+        const std::size_t epoch = slot.epoch.load ();
+        if (epoch != idle)
+          oldest = std::min (oldest, epoch);
+      }
+
+      // a reader pinned at epoch `e` may hold any version retired at `e` or later
+      m_retired.erase (std::remove_if (m_retired.begin (), m_retired.end (),
+                                       [oldest] (const retired_version& r) noexcept
+                                       {
+                                         return r.epoch < oldest;
+                                       }),
+                       m_retired.end ());
+      return m_retired.size ();
+    }
+
+    std::atomic<partition_type *>              m_current;
+    std::atomic<std::size_t>                   m_epoch { 1 };
+    mutable detail::aligned_array<reader_slot> m_slots;
+    std::mutex                                 m_write_mutex;
+    std::vector<retired_version>               m_retired;
+  };
+
+  template <typename Partition>
+  constexpr std::size_t epoch_partition<Partition>::idle;
+
+}
+
+#endif // PARTITION_EPOCH_PARTITION_HPP
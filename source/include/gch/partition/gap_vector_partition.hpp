@@ -0,0 +1,1146 @@
+/** gap_vector_partition.hpp
+ * Short description here.
+ *
+ * Copyright © 2020 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef PARTITION_GAP_VECTOR_PARTITION_HPP
+#define PARTITION_GAP_VECTOR_PARTITION_HPP
+
+#include "partition.hpp"
+
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#ifndef GCH_CPP17_ALLOC_CONSTRUCT_NOEXCEPT
+#  if defined (__cpp_lib_allocator_traits_is_always_equal) \
+      && __cpp_lib_allocator_traits_is_always_equal >= 201411L
+#    define GCH_CPP17_ALLOC_CONSTRUCT_NOEXCEPT noexcept
+#  else
+#    define GCH_CPP17_ALLOC_CONSTRUCT_NOEXCEPT
+#  endif
+#endif
+
+namespace gch
+{
+
+  // A vector partition which keeps slack (a gap) after every subrange. Inserting into a subrange
+  // only shifts elements up to the nearest gap which is large enough, and the gaps are
+  // redistributed (with growth) once they run out. The gap slots hold value-initialized or
+  // moved-from objects, so `T` must be default-constructible and move-assignable.
+  template <typename T, std::size_t N, typename Container = std::vector<T>>
+  class gap_vector_partition;
+
+  template <typename T, std::size_t N, typename Container, std::size_t Index>
+  class partition_subrange<gap_vector_partition<T, N, Container>, Index,
+                           typename std::enable_if<(Index < N)>::type>
+    : public partition_subrange<gap_vector_partition<T, N, Container>, Index + 1>
+  {
+    template <typename, std::size_t, typename>
+    friend class partition_subrange;
+
+  public:
+    using partition_type = gap_vector_partition<T, N, Container>;
+    using subrange_type  = partition_subrange<partition_type, Index>;
+    using next_type      = partition_subrange<partition_type, Index + 1>;
+
+    using container_type         = Container;
+    using iterator               = typename Container::iterator;
+    using const_iterator         = typename Container::const_iterator;
+    using reverse_iterator       = typename Container::reverse_iterator;
+    using const_reverse_iterator = typename Container::const_reverse_iterator;
+    using reference              = typename Container::reference;
+    using const_reference        = typename Container::const_reference;
+    using size_type              = typename Container::size_type;
+    using difference_type        = typename Container::difference_type;
+    using value_type             = typename Container::value_type;
+    using allocator_type         = typename Container::allocator_type;
+
+  private:
+    using iter     = iterator;
+    using citer    = const_iterator;
+    using riter    = reverse_iterator;
+    using criter   = const_reverse_iterator;
+    using ref      = reference;
+    using cref     = const_reference;
+    using size_ty  = size_type;
+    using diff_ty  = difference_type;
+    using value_ty = value_type;
+    using alloc_ty = allocator_type;
+
+  protected:
+    using next_type::m_container;
+    using next_type::m_first;
+    using next_type::m_last;
+
+  public:
+    partition_subrange            (void)                          = default;
+    partition_subrange            (const partition_subrange&)     = default;
+    partition_subrange            (partition_subrange&&) noexcept = default;
+//  partition_subrange& operator= (const partition_subrange&)     = impl;
+//  partition_subrange& operator= (partition_subrange&&) noexcept = impl;
+    ~partition_subrange           (void)                          = default;
+
+  protected:
+    constexpr explicit partition_subrange (const alloc_ty& alloc)
+      : next_type (alloc)
+    { }
+
+  public:
+    partition_subrange& operator= (const partition_subrange& other)
+    {
+      if (&other != this)
+        assign (other.begin (), other.end ());
+      return *this;
+    }
+
+    partition_subrange& operator= (partition_subrange&& other)
+    {
+      if (&other != this)
+        assign (std::make_move_iterator (other.begin ()), std::make_move_iterator (other.end ()));
+      return *this;
+    }
+
+    void assign (size_ty count, const value_ty& val)
+    {
+      iter it = begin ();
+      for (; it != end () && count != 0; ++it, --count)
+        *it = val;
+
+      if (count > 0)
+        insert (end (), count, val);
+      else
+        erase (it, end ());
+    }
+
+    template <typename It>
+    void assign (It first, It last)
+    {
+      iter curr = begin ();
+      for (; curr != end () && first != last; ++curr, (void)++first)
+        *curr = *first;
+
+      if (first == last)
+        erase (curr, end ());
+      else
+        insert (end (), first, last);
+    }
+
+    void assign (std::initializer_list<value_ty> ilist)
+    {
+      assign (ilist.begin (), ilist.end ());
+    }
+
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR iter   begin   (void)       noexcept { return std::next (m_container.begin (), m_first[Index]);  }
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR citer  begin   (void) const noexcept { return std::next (m_container.cbegin (), m_first[Index]); }
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR citer  cbegin  (void) const noexcept { return std::next (m_container.cbegin (), m_first[Index]); }
+
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR iter   end     (void)       noexcept { return std::next (m_container.begin (), m_last[Index]);   }
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR citer  end     (void) const noexcept { return std::next (m_container.cbegin (), m_last[Index]);  }
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR citer  cend    (void) const noexcept { return std::next (m_container.cbegin (), m_last[Index]);  }
+
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR riter  rbegin  (void)       noexcept { return riter (end ());                                    }
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR criter rbegin  (void) const noexcept { return criter (cend ());                                  }
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR criter crbegin (void) const noexcept { return criter (cend ());                                  }
+
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR riter  rend    (void)       noexcept { return riter (begin ());                                  }
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR criter rend    (void) const noexcept { return criter (cbegin ());                                }
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR criter crend   (void) const noexcept { return criter (cbegin ());                                }
+
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR ref&   front   (void)       noexcept { return *begin ();                                         }
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR cref&  front   (void) const noexcept { return *begin ();                                         }
+
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR ref&   back    (void)       noexcept { return *(--end ());                                       }
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR cref&  back    (void) const noexcept { return *(--cend ());                                      }
+
+    GCH_NODISCARD GCH_CPP17_CONSTEXPR size_ty size (void) const noexcept
+    {
+      return static_cast<size_ty> (m_last[Index] - m_first[Index]);
+    }
+
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR bool empty (void) const noexcept
+    {
+      return m_first[Index] == m_last[Index];
+    }
+
+    void clear (void) noexcept
+    {
+      erase (cbegin (), cend ());
+    }
+
+    iter insert (const citer pos, const value_ty& lv)
+    {
+      // copy first in case `lv` is an element which gets shifted
+      value_ty tmp (lv);
+      iter ret = next_type::make_room (Index, pos, 1);
+      *ret = std::move (tmp);
+      return ret;
+    }
+
+    iter insert (const citer pos, value_ty&& rv)
+    {
+      value_ty tmp (std::move (rv));
+      iter ret = next_type::make_room (Index, pos, 1);
+      *ret = std::move (tmp);
+      return ret;
+    }
+
+    iter insert (const citer pos, size_ty count, const value_ty& val)
+    {
+      value_ty tmp (val);
+      iter ret = next_type::make_room (Index, pos, count);
+      try
+      {
+        std::fill_n (ret, count, tmp);
+      }
+      catch (...)
+      {
+        next_type::erase_range (Index, ret, std::next (ret, static_cast<diff_ty> (count)));
+        throw;
+      }
+      return ret;
+    }
+
+    template <typename Iterator>
+    iter insert (const citer pos, Iterator first, Iterator last)
+    {
+      return next_type::insert_range (Index, pos, first, last,
+                                      typename std::iterator_traits<Iterator>::iterator_category ());
+    }
+
+    iter insert (const citer pos, std::initializer_list<value_ty> ilist)
+    {
+      return insert (pos, ilist.begin (), ilist.end ());
+    }
+
+    template <typename ...Args>
+    iter emplace (const citer pos, Args&&... args)
+    {
+      value_ty tmp (std::forward<Args> (args)...);
+      iter ret = next_type::make_room (Index, pos, 1);
+      *ret = std::move (tmp);
+      return ret;
+    }
+
+    iter erase (const citer pos)
+    {
+      return next_type::erase_range (Index, pos, std::next (pos));
+    }
+
+    iter erase (const citer first, const citer last)
+    {
+      return next_type::erase_range (Index, first, last);
+    }
+
+    void push_back (const value_ty& val)
+    {
+      insert (cend (), val);
+    }
+
+    void push_back (value_ty&& val)
+    {
+      insert (cend (), std::move (val));
+    }
+
+    template <typename ...Args>
+    ref emplace_back (Args&&... args)
+    {
+      return *emplace (cend (), std::forward<Args> (args)...);
+    }
+
+    void pop_back (void)
+    {
+      erase (--cend ());
+    }
+
+    void push_front (const value_ty& val)
+    {
+      insert (cbegin (), val);
+    }
+
+    void push_front (value_ty&& val)
+    {
+      insert (cbegin (), std::move (val));
+    }
+
+    template <typename ...Args>
+    ref emplace_front (Args&&... args)
+    {
+      return *emplace (cbegin (), std::forward<Args> (args)...);
+    }
+
+    void pop_front (void)
+    {
+      erase (cbegin ());
+    }
+
+    void resize (size_ty count)
+    {
+      resize (count, { });
+    }
+
+    void resize (size_ty count, const value_ty& val)
+    {
+      if (count > size ())
+        insert (cend (), count - size (), val);
+      else if (count < size ())
+        erase (std::next (cbegin (), static_cast<diff_ty> (count)), cend ());
+    }
+
+    template <std::size_t M, std::size_t J>
+    void swap (partition_subrange<gap_vector_partition<T, M, Container>, J>& other)
+    {
+      // every subrange of a partition shares the same address, so the index has to match as well
+      if (M == N && J == Index && static_cast<void *> (&other) == static_cast<void *> (this))
+        return;
+
+      const diff_ty common = static_cast<diff_ty> (std::min (size (), other.size ()));
+      std::swap_ranges (begin (), std::next (begin (), common), other.begin ());
+      if (size () > other.size ())
+        move_tail (common, other);
+      else if (other.size () > size ())
+        other.move_tail (common, *this);
+    }
+
+    subrange_view<iter> view (void)
+    {
+      return { begin (), end () };
+    }
+
+    subrange_view<citer> view (void) const
+    {
+      return { begin (), end () };
+    }
+
+  private:
+    // Moves the elements from position `pos` on to the back of `dest`. Both may live in the same
+    // buffer, and inserting into `dest` can shift this subrange, so the tail is taken out first.
+    template <typename Subrange>
+    void move_tail (diff_ty pos, Subrange& dest)
+    {
+      container_type tail (std::make_move_iterator (std::next (begin (), pos)),
+                           std::make_move_iterator (end ()), m_container.get_allocator ());
+      try
+      {
+        dest.insert (dest.end (), std::make_move_iterator (tail.begin ()),
+                     std::make_move_iterator (tail.end ()));
+      }
+      catch (...)
+      {
+        std::move (tail.begin (), tail.end (), std::next (begin (), pos));
+        throw;
+      }
+      erase (std::next (cbegin (), pos), cend ());
+    }
+
+  public:
+    template <std::size_t J = Index, typename std::enable_if<(0 < J)>::type * = nullptr>
+    iter advance_begin (diff_ty change)
+    {
+      return next_type::move_boundary (Index, change);
+    }
+
+    template <std::size_t J = Index, typename std::enable_if<(J == 0)>::type * = nullptr>
+    iter advance_begin (diff_ty change) = delete;
+
+    template <std::size_t J = Index, typename std::enable_if<(J < N - 1)>::type * = nullptr>
+    iter advance_end (diff_ty change)
+    {
+      return next_subrange (*this).advance_begin (change);
+    }
+
+    template <std::size_t J = Index, typename std::enable_if<(J == N - 1)>::type * = nullptr>
+    iter advance_end (diff_ty change) = delete;
+  };
+
+  // end case holds the actual container and the extents of every subrange
+  template <typename T, std::size_t N, typename Container>
+  class partition_subrange<gap_vector_partition<T, N, Container>, N>
+  {
+    template <typename, std::size_t, typename>
+    friend class partition_subrange;
+
+  public:
+    using partition_type = gap_vector_partition<T, N, Container>;
+    using subrange_type  = partition_subrange<partition_type, N>;
+    using prev_type      = partition_subrange<partition_type, N - 1>;
+//  using next_type      = void;
+
+    using container_type         = Container;
+    using iterator               = typename Container::iterator;
+    using const_iterator         = typename Container::const_iterator;
+    using reverse_iterator       = typename Container::reverse_iterator;
+    using const_reverse_iterator = typename Container::const_reverse_iterator;
+    using reference              = typename Container::reference;
+    using const_reference        = typename Container::const_reference;
+    using size_type              = typename Container::size_type;
+    using difference_type        = typename Container::difference_type;
+    using value_type             = typename Container::value_type;
+    using allocator_type         = typename Container::allocator_type;
+
+  private:
+    using iter     = iterator;
+    using citer    = const_iterator;
+    using riter    = reverse_iterator;
+    using criter   = const_reverse_iterator;
+    using ref      = reference;
+    using cref     = const_reference;
+    using size_ty  = size_type;
+    using diff_ty  = difference_type;
+    using value_ty = value_type;
+    using alloc_ty = allocator_type;
+
+    using offset_array = std::array<diff_ty, N>;
+
+  public:
+    partition_subrange            (void)                          = default;
+    partition_subrange            (const partition_subrange&)     = default;
+    partition_subrange            (partition_subrange&&) noexcept = default;
+    partition_subrange& operator= (const partition_subrange&)     = default;
+    partition_subrange& operator= (partition_subrange&&) noexcept = default;
+    ~partition_subrange           (void)                          = default;
+
+  protected:
+    GCH_CPP20_CONSTEXPR explicit
+    partition_subrange (const alloc_ty& alloc)
+    GCH_CPP17_ALLOC_CONSTRUCT_NOEXCEPT
+      : m_container (alloc)
+    { }
+
+  public:
+    GCH_CPP20_CONSTEXPR
+    alloc_ty
+    get_allocator (void) const noexcept
+    {
+      return m_container.get_allocator ();
+    }
+
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR
+    size_ty
+    max_size (void) const noexcept
+    {
+      return m_container.max_size ();
+    }
+
+    subrange_view<iter>  view (void)       = delete;
+    subrange_view<citer> view (void) const = delete;
+
+    iter advance_begin (diff_ty) = delete;
+    iter advance_end   (diff_ty) = delete;
+
+  protected:
+    template <typename U>
+    struct is_nothrow_swappable
+    {
+      static constexpr bool test (void)
+      {
+        using std::swap;
+        return noexcept (swap (std::declval<U&> (), std::declval<U&> ()));
+      }
+
+      static constexpr bool value = test ();
+    };
+
+    void partition_swap (partition_subrange& other)
+      noexcept (is_nothrow_swappable<container_type>::value)
+    {
+      using std::swap;
+      swap (m_container, other.m_container);
+      swap (m_first, other.m_first);
+      swap (m_last, other.m_last);
+    }
+
+    iter  slot (diff_ty off)       noexcept { return std::next (m_container.begin (), off);  }
+    citer slot (diff_ty off) const noexcept { return std::next (m_container.cbegin (), off); }
+
+    diff_ty
+    subrange_size (std::size_t idx) const noexcept
+    {
+      return m_last[idx] - m_first[idx];
+    }
+
+    diff_ty
+    gap_before (std::size_t idx) const noexcept
+    {
+      return m_first[idx] - (idx == 0 ? 0 : m_last[idx - 1]);
+    }
+
+    diff_ty
+    gap_after (std::size_t idx) const noexcept
+    {
+      return (idx + 1 == N ? static_cast<diff_ty> (m_container.size ()) : m_first[idx + 1])
+           - m_last[idx];
+    }
+
+    size_ty
+    data_size (void) const noexcept
+    {
+      diff_ty ret = 0;
+      for (std::size_t i = 0; i < N; ++i)
+        ret += subrange_size (i);
+      return static_cast<size_ty> (ret);
+    }
+
+    // Opens `count` slots at `pos` in subrange `idx` and returns an iterator to the first one.
+    // The slots hold unspecified values which the caller is expected to overwrite.
+    iter
+    make_room (std::size_t idx, citer pos, size_ty count)
+    {
+      const diff_ty change = static_cast<diff_ty> (count);
+      const diff_ty off    = std::distance (m_container.cbegin (), pos);
+      if (change == 0)
+        return slot (off);
+
+      if (change <= gap_after (idx))
+        return shift_right (idx, idx, off, change);
+
+      if (change <= gap_before (idx))
+        return shift_left (idx, idx, off, change);
+
+      std::size_t right = idx + 1;
+      while (right < N && gap_after (right) < change)
+        ++right;
+
+      std::size_t left = idx;
+      for (std::size_t j = idx; j-- != 0;)
+      {
+        if (change <= gap_before (j))
+        {
+          left = j;
+          break;
+        }
+      }
+
+      // shift toward whichever gap requires moving fewer elements
+      if (right < N && (left == idx || m_last[right] - off <= off - m_first[left]))
+        return shift_right (idx, right, off, change);
+
+      if (left != idx)
+        return shift_left (idx, left, off, change);
+
+      const diff_ty rel = off - m_first[idx];
+      const size_ty len = data_size ();
+      relayout (len + count + std::max (len, static_cast<size_ty> (N)), idx, count);
+      return shift_right (idx, idx, m_first[idx] + rel, change);
+    }
+
+    template <typename It>
+    iter
+    insert_range (std::size_t idx, citer pos, It first, It last, std::input_iterator_tag)
+    {
+      container_type tmp (first, last, m_container.get_allocator ());
+      return insert_range (idx, pos, std::make_move_iterator (tmp.begin ()),
+                           std::make_move_iterator (tmp.end ()), std::forward_iterator_tag ());
+    }
+
+    template <typename It>
+    iter
+    insert_range (std::size_t idx, citer pos, It first, It last, std::forward_iterator_tag)
+    {
+      const size_ty count = static_cast<size_ty> (std::distance (first, last));
+      iter ret = make_room (idx, pos, count);
+      try
+      {
+        std::copy (first, last, ret);
+      }
+      catch (...)
+      {
+        erase_range (idx, ret, std::next (ret, static_cast<diff_ty> (count)));
+        throw;
+      }
+      return ret;
+    }
+
+    iter
+    erase_range (std::size_t idx, citer first, citer last)
+    {
+      const diff_ty f = std::distance (m_container.cbegin (), first);
+      const diff_ty l = std::distance (m_container.cbegin (), last);
+      const diff_ty n = l - f;
+      if (n == 0)
+        return slot (f);
+
+      // close the hole from whichever side has fewer elements
+      if (f - m_first[idx] < m_last[idx] - l)
+      {
+        std::move_backward (slot (m_first[idx]), slot (f), slot (l));
+        release (m_first[idx], m_first[idx] + n);
+        m_first[idx] += n;
+        return slot (l);
+      }
+
+      std::move (slot (l), slot (m_last[idx]), slot (f));
+      release (m_last[idx] - n, m_last[idx]);
+      m_last[idx] -= n;
+      return slot (f);
+    }
+
+    // same semantics as `vector_partition`: moving a boundary past other boundaries pushes them
+    // along with it.
+    iter
+    move_boundary (std::size_t idx, diff_ty change)
+    {
+      if (change > 0)
+      {
+        diff_ty avail = 0;
+        for (std::size_t i = idx; i < N; ++i)
+          avail += subrange_size (i);
+
+        if (change > avail)
+          throw std::out_of_range ("requested change of subrange offset is out of range");
+
+        diff_ty     dest = m_last[idx - 1];
+        std::size_t j    = idx;
+        for (diff_ty remaining = change; ; ++j)
+        {
+          const diff_ty take = std::min (remaining, subrange_size (j));
+          if (dest != m_first[j])
+            std::move (slot (m_first[j]), slot (m_first[j] + take), slot (dest));
+
+          dest       += take;
+          m_first[j] += take;
+          remaining  -= take;
+          if (remaining == 0)
+            break;
+        }
+
+        m_last[idx - 1] = dest;
+        for (std::size_t i = idx; i < j; ++i)
+          m_first[i] = m_last[i] = dest;
+      }
+      else if (change < 0)
+      {
+        diff_ty avail = 0;
+        for (std::size_t i = 0; i < idx; ++i)
+          avail += subrange_size (i);
+
+        if (-change > avail)
+          throw std::out_of_range ("requested change of subrange offset is out of range");
+
+        diff_ty     dest = m_first[idx];
+        std::size_t j    = idx - 1;
+        for (diff_ty remaining = -change; ; --j)
+        {
+          const diff_ty take = std::min (remaining, subrange_size (j));
+          if (dest != m_last[j])
+            std::move_backward (slot (m_last[j] - take), slot (m_last[j]), slot (dest));
+
+          dest      -= take;
+          m_last[j] -= take;
+          remaining -= take;
+          if (remaining == 0)
+            break;
+        }
+
+        m_first[idx] = dest;
+        for (std::size_t i = j + 1; i < idx; ++i)
+          m_first[i] = m_last[i] = dest;
+      }
+      return slot (m_first[idx]);
+    }
+
+    // Moves every subrange into a new buffer with `capacity` slots. Subrange `idx` gets `count`
+    // slots of slack in addition to its share of the rest. If anything throws the partition is
+    // left as it was (see `relocate_by_move`).
+    void
+    relayout (size_ty capacity, std::size_t idx, size_ty count)
+    {
+      const size_ty extra = capacity - data_size () - count;
+
+      container_type tmp (m_container.get_allocator ());
+      tmp.reserve (capacity);
+
+      offset_array first { };
+      offset_array last { };
+      std::size_t  i = 0;
+      try
+      {
+        for (; i < N; ++i)
+        {
+          first[i] = static_cast<diff_ty> (tmp.size ());
+          relocate_subrange (tmp, i, relocate_by_move { });
+          last[i] = static_cast<diff_ty> (tmp.size ());
+
+          size_ty gap = extra / N + (i < extra % N ? 1 : 0);
+          if (i == idx)
+            gap += count;
+          tmp.resize (tmp.size () + gap);
+        }
+      }
+      catch (...)
+      {
+        restore_relocated (tmp, first, last, i + 1);
+        throw;
+      }
+
+      m_container.swap (tmp);
+      m_first = first;
+      m_last  = last;
+    }
+
+    template <std::size_t M>
+    void
+    append_subranges (std::size_t idx,
+                      const partition_subrange<gap_vector_partition<T, M, Container>, M>& other)
+    {
+      for (std::size_t j = 0; j < M; ++j, ++idx)
+      {
+        m_first[idx] = static_cast<diff_ty> (m_container.size ());
+        m_container.insert (m_container.end (), other.slot (other.m_first[j]),
+                            other.slot (other.m_last[j]));
+        m_last[idx] = static_cast<diff_ty> (m_container.size ());
+      }
+    }
+
+    template <std::size_t M>
+    void
+    append_subranges (std::size_t idx,
+                      partition_subrange<gap_vector_partition<T, M, Container>, M>&& other)
+    {
+      for (std::size_t j = 0; j < M; ++j, ++idx)
+      {
+        m_first[idx] = static_cast<diff_ty> (m_container.size ());
+        m_container.insert (m_container.end (),
+                            std::make_move_iterator (other.slot (other.m_first[j])),
+                            std::make_move_iterator (other.slot (other.m_last[j])));
+        m_last[idx] = static_cast<diff_ty> (m_container.size ());
+      }
+    }
+
+  private:
+    // The old elements are only moved into a new buffer if they can be moved back without
+    // throwing. Otherwise they are copied, and the originals stay untouched until the swap.
+    using relocate_by_move = std::integral_constant<bool,
+      (std::is_nothrow_move_constructible<value_ty>::value
+       && std::is_nothrow_move_assignable<value_ty>::value)
+      || ! std::is_copy_constructible<value_ty>::value>;
+
+    void
+    relocate_subrange (container_type& tmp, std::size_t idx, std::true_type)
+    {
+      tmp.insert (tmp.end (), std::make_move_iterator (slot (m_first[idx])),
+                  std::make_move_iterator (slot (m_last[idx])));
+    }
+
+    void
+    relocate_subrange (container_type& tmp, std::size_t idx, std::false_type)
+    {
+      tmp.insert (tmp.end (), slot (m_first[idx]), slot (m_last[idx]));
+    }
+
+    // Undoes the relocation of the first `count` subranges into `tmp` after a failure. Copied
+    // elements were never touched, and move-only types that may throw cannot be restored.
+    void
+    restore_relocated (container_type& tmp, const offset_array& first, const offset_array& last,
+                       std::size_t count) noexcept
+    {
+      if (! std::is_nothrow_move_constructible<value_ty>::value
+          || ! std::is_nothrow_move_assignable<value_ty>::value)
+      {
+        return;
+      }
+
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        std::move (std::next (tmp.begin (), first[i]), std::next (tmp.begin (), last[i]),
+                   slot (m_first[i]));
+      }
+    }
+
+    iter
+    shift_right (std::size_t idx, std::size_t last_idx, diff_ty off, diff_ty change)
+    {
+      std::move_backward (slot (off), slot (m_last[last_idx]), slot (m_last[last_idx] + change));
+      for (std::size_t i = idx + 1; i <= last_idx; ++i)
+      {
+        m_first[i] += change;
+        m_last[i]  += change;
+      }
+      m_last[idx] += change;
+      return slot (off);
+    }
+
+    iter
+    shift_left (std::size_t idx, std::size_t first_idx, diff_ty off, diff_ty change)
+    {
+      std::move (slot (m_first[first_idx]), slot (off), slot (m_first[first_idx] - change));
+      for (std::size_t i = first_idx; i < idx; ++i)
+      {
+        m_first[i] -= change;
+        m_last[i]  -= change;
+      }
+      m_first[idx] -= change;
+      return slot (off - change);
+    }
+
+    // erased values should not linger in the gaps
+    void
+    release (diff_ty first, diff_ty last)
+    {
+      for (iter it = slot (first), e = slot (last); it != e; ++it)
+        *it = value_ty ();
+    }
+
+  protected:
+    container_type m_container;
+    offset_array   m_first { };
+    offset_array   m_last  { };
+  };
+
+  template <typename T, std::size_t N, typename C, std::size_t I>
+  void swap (partition_subrange<gap_vector_partition<T, N, C>, I>& lhs,
+             partition_subrange<gap_vector_partition<T, N, C>, I>& rhs)
+  {
+    lhs.swap (rhs);
+  }
+
+  template <typename T, typename C, std::size_t N, std::size_t I, std::size_t M, std::size_t J>
+  void swap (partition_subrange<gap_vector_partition<T, N, C>, I>& lhs,
+             partition_subrange<gap_vector_partition<T, M, C>, J>& rhs)
+  {
+    lhs.swap (rhs);
+  }
+
+  template <typename T, std::size_t N, typename C, std::size_t I, typename U>
+  typename partition_subrange<gap_vector_partition<T, N, C>, I>::size_type
+  erase (partition_subrange<gap_vector_partition<T, N, C>, I>& c, const U& val)
+  {
+    auto it = std::remove (c.begin (), c.end (), val);
+    auto r  = std::distance (it, c.end ());
+    c.erase (it, c.end ());
+    return static_cast<typename partition_subrange<gap_vector_partition<T, N, C>, I>::size_type> (r);
+  }
+
+  template <typename T, std::size_t N, typename C, std::size_t I, typename Pred>
+  typename partition_subrange<gap_vector_partition<T, N, C>, I>::size_type
+  erase_if (partition_subrange<gap_vector_partition<T, N, C>, I>& c, Pred pred)
+  {
+    auto it = std::remove_if (c.begin (), c.end (), pred);
+    auto r  = std::distance (it, c.end ());
+    c.erase (it, c.end ());
+    return static_cast<typename partition_subrange<gap_vector_partition<T, N, C>, I>::size_type> (r);
+  }
+
+  template <typename T, std::size_t N, typename Container>
+  class gap_vector_partition
+    : public partition_traits<gap_vector_partition<T, N, Container>>,
+      protected partition_subrange<gap_vector_partition<T, N, Container>, 0>
+  {
+  public:
+    using traits = partition_traits<gap_vector_partition>;
+
+    using container_type = typename traits::container_type;
+
+    using data_iter    = typename traits::data_iterator;
+    using data_citer   = typename traits::data_const_iterator;
+    using data_riter   = typename traits::data_reverse_iterator;
+    using data_criter  = typename traits::data_const_reverse_iterator;
+    using data_ref     = typename traits::data_reference;
+    using data_cref    = typename traits::data_const_reference;
+    using data_size_t  = typename traits::data_size_type;
+    using data_diff_t  = typename traits::data_difference_type;
+    using data_val_t   = typename traits::data_value_type;
+    using data_alloc_t = typename traits::data_allocator_type;
+
+    using first_type = partition_subrange<gap_vector_partition, 0>;
+    using last_type  = partition_subrange<gap_vector_partition, N>;
+
+    template <std::size_t Index>
+    using subrange_type = partition_subrange<gap_vector_partition, Index>;
+
+  protected:
+    using last_type::m_container;
+
+  public:
+    gap_vector_partition            (void)                            = default;
+    gap_vector_partition            (const gap_vector_partition&)     = default;
+    gap_vector_partition            (gap_vector_partition&&) noexcept = default;
+//  gap_vector_partition& operator= (const gap_vector_partition&)     = impl;
+//  gap_vector_partition& operator= (gap_vector_partition&&) noexcept = impl;
+    ~gap_vector_partition           (void)                            = default;
+
+    gap_vector_partition& operator= (const gap_vector_partition& other)
+    {
+      if (&other != this)
+      {
+        gap_vector_partition tmp (other);
+        swap (tmp);
+      }
+      return *this;
+    }
+
+    gap_vector_partition& operator= (gap_vector_partition&& other) noexcept
+    {
+      if (&other != this)
+        swap (other);
+      return *this;
+    }
+
+    // concatenation constructor
+    template <std::size_t M, typename ...Partitions>
+    gap_vector_partition (const gap_vector_partition<T, M, Container>& p, Partitions&&... ps)
+    {
+      m_container.reserve (total_data_size (p, ps...));
+      construct (0, p, std::forward<Partitions> (ps)...);
+    }
+
+    template <std::size_t M, typename ...Partitions>
+    gap_vector_partition (gap_vector_partition<T, M, Container>&& p, Partitions&&... ps)
+    {
+      m_container.reserve (total_data_size (p, ps...));
+      construct (0, std::move (p), std::forward<Partitions> (ps)...);
+    }
+
+  private:
+    template <std::size_t M, typename ...Partitions>
+    void construct (std::size_t idx, const gap_vector_partition<T, M, Container>& p,
+                    Partitions&&... ps)
+    {
+      last_type::append_subranges (idx, get_subrange<M> (p));
+      construct (idx + M, std::forward<Partitions> (ps)...);
+    }
+
+    template <std::size_t M, typename ...Partitions>
+    void construct (std::size_t idx, gap_vector_partition<T, M, Container>&& p, Partitions&&... ps)
+    {
+      last_type::append_subranges (idx, get_subrange<M> (std::move (p)));
+      construct (idx + M, std::forward<Partitions> (ps)...);
+    }
+
+    static void construct (std::size_t) noexcept { }
+
+    template <typename P, typename ...Partitions>
+    static data_size_t total_data_size (const P& p, const Partitions&... ps) noexcept
+    {
+      return p.data_size () + total_data_size (ps...);
+    }
+
+    static constexpr data_size_t total_data_size (void) noexcept { return 0; }
+
+  public:
+    constexpr explicit gap_vector_partition (const data_alloc_t& alloc)
+      : first_type (alloc)
+    { }
+
+    template <std::size_t I, typename PartitionRef>
+    friend constexpr
+    get_subrange_t<I, PartitionRef>
+    get_subrange (PartitionRef&& p) noexcept;
+
+    template <typename SubrangeRef>
+    friend constexpr
+    get_partition_t<SubrangeRef>
+    get_partition (SubrangeRef&& s) noexcept;
+
+    GCH_CPP14_CONSTEXPR subrange_type<0>& front (void) noexcept
+    {
+      return get_subrange<0> (*this);
+    }
+
+    constexpr const subrange_type<0>& front (void) const noexcept
+    {
+      return get_subrange<0> (*this);
+    }
+
+    GCH_CPP14_CONSTEXPR subrange_type<N - 1>& back (void) noexcept
+    {
+      return get_subrange<N - 1> (*this);
+    }
+
+    constexpr const subrange_type<N - 1>& back (void) const noexcept
+    {
+      return get_subrange<N - 1> (*this);
+    }
+
+    static constexpr data_size_t size (void) noexcept { return N; }
+    GCH_NODISCARD static constexpr bool empty (void) noexcept { return N == 0; }
+
+    data_size_t data_size (void) const noexcept { return last_type::data_size (); }
+    GCH_NODISCARD bool data_empty (void) const noexcept { return data_size () == 0; }
+
+    // number of slots in the buffer, including the gaps
+    data_size_t data_capacity (void) const noexcept { return m_container.size (); }
+
+    void
+    reserve (data_size_t new_cap)
+    {
+      if (new_cap > m_container.size ())
+        last_type::relayout (new_cap, 0, 0);
+    }
+
+    void
+    shrink_to_fit (void)
+    {
+      last_type::relayout (data_size (), 0, 0);
+    }
+
+    partition_view<gap_vector_partition, N>
+    get_partition_view (void)
+    {
+      return partition_view<gap_vector_partition, N> (*this);
+    }
+
+    partition_view<const gap_vector_partition, N>
+    get_partition_view (void) const
+    {
+      return partition_view<const gap_vector_partition, N> (*this);
+    }
+
+    template <std::size_t Idx>
+    subrange_view<data_iter>
+    get_subrange_view (void)
+    {
+      return get_subrange<Idx> (*this).view ();
+    }
+
+    template <std::size_t Idx>
+    subrange_view<data_citer>
+    get_subrange_view (void) const
+    {
+      return get_subrange<Idx> (*this).view ();
+    }
+
+    template <std::size_t Index,
+              typename = typename std::enable_if<(0 < Index) && (Index < N)>::type>
+    data_iter
+    advance_begin (data_diff_t change)
+    {
+      return get_subrange<Index> (*this).advance_begin (change);
+    }
+
+    template <std::size_t Index,
+              typename = typename std::enable_if<(Index < N)>::type>
+    data_iter
+    advance_end (data_diff_t change)
+    {
+      return get_subrange<Index> (*this).advance_end (change);
+    }
+
+    void
+    swap (gap_vector_partition& other)
+      noexcept (noexcept (std::declval<gap_vector_partition&> ().partition_swap (other)))
+    {
+      last_type::partition_swap (other);
+    }
+
+#ifdef GCH_PARTITION_ITERATOR
+
+    using iter   = partition_iterator<gap_vector_partition>;
+    using citer  = partition_iterator<const gap_vector_partition>;
+    using riter  = std::reverse_iterator<iter>;
+    using criter = std::reverse_iterator<citer>;
+
+    [[nodiscard]] constexpr iter  begin   (void)       noexcept { return { *this, 0 };       }
+    [[nodiscard]] constexpr citer begin   (void) const noexcept { return { *this, 0 };       }
+    [[nodiscard]] constexpr citer cbegin  (void) const noexcept { return { *this, 0 };       }
+
+    [[nodiscard]] constexpr iter  end     (void)       noexcept { return { *this, N };       }
+    [[nodiscard]] constexpr citer end     (void) const noexcept { return { *this, N };       }
+    [[nodiscard]] constexpr citer cend    (void) const noexcept { return { *this, N };       }
+
+    [[nodiscard]] constexpr auto  rbegin  (void)       noexcept { return riter (end ());     }
+    [[nodiscard]] constexpr auto  rbegin  (void) const noexcept { return criter (cend ());   }
+    [[nodiscard]] constexpr auto  crbegin (void) const noexcept { return criter (cend ());   }
+
+    [[nodiscard]] constexpr auto  rend    (void)       noexcept { return riter (begin ());   }
+    [[nodiscard]] constexpr auto  rend    (void) const noexcept { return criter (cbegin ()); }
+    [[nodiscard]] constexpr auto  crend   (void) const noexcept { return criter (cbegin ()); }
+
+    template <typename ...Fs>
+    static constexpr auto overload (Fs&&... fs) noexcept
+    {
+      return partition_overloader<gap_vector_partition, Fs...> (std::forward<Fs> (fs)...);
+    }
+
+#endif
+  };
+
+  template <typename T, std::size_t N, typename Container>
+  void swap (gap_vector_partition<T, N, Container>& lhs, gap_vector_partition<T, N, Container>& rhs)
+  {
+    lhs.swap (rhs);
+  }
+
+  template <typename T, typename C, std::size_t N, std::size_t I, std::size_t M, std::size_t J>
+  GCH_ALG_CONSTEXPR bool operator== (const partition_subrange<gap_vector_partition<T, N, C>, I>& lhs,
+                                     const partition_subrange<gap_vector_partition<T, M, C>, J>& rhs)
+  {
+    return lhs.size () == rhs.size () && std::equal (lhs.begin (), lhs.end (), rhs.begin ());
+  }
+
+#ifdef GCH_LIB_THREE_WAY_COMPARISON
+
+  template <typename T, typename C, std::size_t N, std::size_t I, std::size_t M, std::size_t J>
+  constexpr auto operator<=> (const partition_subrange<gap_vector_partition<T, N, C>, I>& lhs,
+                              const partition_subrange<gap_vector_partition<T, M, C>, J>& rhs)
+    requires std::three_way_comparable_with<T, T>
+  {
+    return std::lexicographical_compare_three_way (lhs.begin (), lhs.end (),
+                                                   rhs.begin (), rhs.end (),
+                                                   std::compare_three_way { });
+  }
+
+  template <typename T, typename C, std::size_t N, std::size_t I, std::size_t M, std::size_t J>
+  constexpr auto operator<=> (const partition_subrange<gap_vector_partition<T, N, C>, I>& lhs,
+                              const partition_subrange<gap_vector_partition<T, M, C>, J>& rhs)
+    requires (! std::three_way_comparable_with<T, T>)
+  {
+    constexpr auto comparison = [](const T& l, const T& r)
+                                {
+                                  return (l < r) ? std::weak_ordering::less
+                                                 : (r < l) ? std::weak_ordering::greater
+                                                           : std::weak_ordering::equivalent;
+                                };
+    return std::lexicographical_compare_three_way (lhs.begin (), lhs.end (),
+                                                   rhs.begin (), rhs.end (),
+                                                   comparison);
+  }
+
+#else
+
+  template <typename T, typename C, std::size_t N, std::size_t I, std::size_t M, std::size_t J>
+  bool operator!= (const partition_subrange<gap_vector_partition<T, N, C>, I>& lhs,
+                   const partition_subrange<gap_vector_partition<T, M, C>, J>& rhs)
+  {
+    return ! (lhs == rhs);
+  }
+
+  template <typename T, typename C, std::size_t N, std::size_t I, std::size_t M, std::size_t J>
+  bool operator< (const partition_subrange<gap_vector_partition<T, N, C>, I>& lhs,
+                  const partition_subrange<gap_vector_partition<T, M, C>, J>& rhs)
+  {
+    return std::lexicographical_compare (lhs.begin (), lhs.end (), rhs.begin (), rhs.end ());
+  }
+
+  template <typename T, typename C, std::size_t N, std::size_t I, std::size_t M, std::size_t J>
+  bool operator<= (const partition_subrange<gap_vector_partition<T, N, C>, I>& lhs,
+                   const partition_subrange<gap_vector_partition<T, M, C>, J>& rhs)
+  {
+    return ! (lhs > rhs);
+  }
+
+  template <typename T, typename C, std::size_t N, std::size_t I, std::size_t M, std::size_t J>
+  bool operator> (const partition_subrange<gap_vector_partition<T, N, C>, I>& lhs,
+                  const partition_subrange<gap_vector_partition<T, M, C>, J>& rhs)
+  {
+    return rhs < lhs;
+  }
+
+  template <typename T, typename C, std::size_t N, std::size_t I, std::size_t M, std::size_t J>
+  bool operator>= (const partition_subrange<gap_vector_partition<T, N, C>, I>& lhs,
+                   const partition_subrange<gap_vector_partition<T, M, C>, J>& rhs)
+  {
+    return ! (lhs < rhs);
+  }
+
+#endif
+}
+
+#endif // PARTITION_GAP_VECTOR_PARTITION_HPP
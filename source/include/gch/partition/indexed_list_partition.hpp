@@ -0,0 +1,1187 @@
+/** indexed_list_partition.hpp
+ * Short description here.
+ *
+ * Copyright © 2020 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef PARTITION_INDEXED_LIST_PARTITION_HPP
+#define PARTITION_INDEXED_LIST_PARTITION_HPP
+
+#include "partition.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace gch
+{
+
+  // A sequence with the interface of a list that also knows the position of every element.
+  // The elements are kept in a balanced tree (a treap keyed on position), so `nth`, `index_of`,
+  // insertion and erasure take O(log n), and so does splicing a range of any length. Iterators
+  // stay valid until their element is erased, as with `std::list`.
+  template <typename T, typename Allocator = std::allocator<T>>
+  class indexed_list
+  {
+    struct node_base
+    {
+      node_base     *left     = nullptr;
+      node_base     *right    = nullptr;
+      node_base     *parent   = nullptr;
+      std::size_t    size     = 0;
+      std::uint32_t  priority = 0;
+    };
+
+    struct node
+      : node_base
+    {
+      template <typename ...Args>
+      explicit node (Args&&... args)
+        noexcept (std::is_nothrow_constructible<T, Args...>::value)
+        : value (std::forward<Args> (args)...)
+      { }
+
+      T value;
+    };
+
+    using node_allocator    = typename std::allocator_traits<Allocator>::template rebind_alloc<node>;
+    using node_alloc_traits = std::allocator_traits<node_allocator>;
+
+    template <bool IsConst>
+    class basic_iterator
+    {
+    public:
+      using iterator_category = std::bidirectional_iterator_tag;
+      using value_type        = T;
+      using difference_type   = std::ptrdiff_t;
+      using pointer           = typename std::conditional<IsConst, const T *, T *>::type;
+      using reference         = typename std::conditional<IsConst, const T&, T&>::type;
+
+      basic_iterator (void) = default;
+
+      // conversion to a const iterator
+      template <bool C = IsConst, typename = typename std::enable_if<C>::type>
+      /* implicit */ basic_iterator (const basic_iterator<false>& other) noexcept
+        : m_node (other.m_node)
+      { }
+
+      GCH_NODISCARD reference operator*  (void) const noexcept { return static_cast<node *> (m_node)->value;  }
+      GCH_NODISCARD pointer   operator-> (void) const noexcept { return &static_cast<node *> (m_node)->value; }
+
+      basic_iterator&
+      operator++ (void) noexcept
+      {
+        m_node = next_node (m_node);
+        return *this;
+      }
+
+      basic_iterator
+      operator++ (int) noexcept
+      {
+        basic_iterator ret (*this);
+        ++*this;
+        return ret;
+      }
+
+      basic_iterator&
+      operator-- (void) noexcept
+      {
+        m_node = prev_node (m_node);
+        return *this;
+      }
+
+      basic_iterator
+      operator-- (int) noexcept
+      {
+        basic_iterator ret (*this);
+        --*this;
+        return ret;
+      }
+
+      friend bool
+      operator== (const basic_iterator& lhs, const basic_iterator& rhs) noexcept
+      {
+        return lhs.m_node == rhs.m_node;
+      }
+
+      friend bool
+      operator!= (const basic_iterator& lhs, const basic_iterator& rhs) noexcept
+      {
+        return lhs.m_node != rhs.m_node;
+      }
+
+    private:
+      friend class indexed_list;
+
+      template <bool>
+      friend class basic_iterator;
+
+      explicit basic_iterator (node_base *n) noexcept
+        : m_node (n)
+      { }
+
+      node_base *m_node = nullptr;
+    };
+
+  public:
+    using value_type             = T;
+    using allocator_type         = Allocator;
+    using size_type              = std::size_t;
+    using difference_type        = std::ptrdiff_t;
+    using reference              = T&;
+    using const_reference        = const T&;
+    using pointer                = typename std::allocator_traits<Allocator>::pointer;
+    using const_pointer          = typename std::allocator_traits<Allocator>::const_pointer;
+    using iterator               = basic_iterator<false>;
+    using const_iterator         = basic_iterator<true>;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+  private:
+    using iter     = iterator;
+    using citer    = const_iterator;
+    using size_ty  = size_type;
+    using value_ty = value_type;
+
+  public:
+    indexed_list (void) = default;
+
+    explicit indexed_list (const allocator_type& alloc)
+      : m_alloc (alloc)
+    { }
+
+    template <typename Iterator,
+              typename = typename std::iterator_traits<Iterator>::iterator_category>
+    indexed_list (Iterator first, Iterator last, const allocator_type& alloc = allocator_type ())
+      : m_alloc (alloc)
+    {
+      insert (cend (), first, last);
+    }
+
+    indexed_list (std::initializer_list<value_ty> ilist,
+                  const allocator_type& alloc = allocator_type ())
+      : m_alloc (alloc)
+    {
+      insert (cend (), ilist);
+    }
+
+    indexed_list (const indexed_list& other)
+      : m_alloc (node_alloc_traits::select_on_container_copy_construction (other.m_alloc))
+    {
+      insert (cend (), other.begin (), other.end ());
+    }
+
+    // the end iterator does not follow the elements
+    indexed_list (indexed_list&& other) noexcept
+      : m_alloc (std::move (other.m_alloc)),
+        m_seed  (other.m_seed)
+    {
+      set_root (other.root ());
+      other.set_root (nullptr);
+    }
+
+    indexed_list&
+    operator= (const indexed_list& other)
+    {
+      if (&other != this)
+      {
+        indexed_list tmp (other);
+        swap (tmp);
+      }
+      return *this;
+    }
+
+    indexed_list&
+    operator= (indexed_list&& other) noexcept
+    {
+      indexed_list tmp (std::move (other));
+      swap (tmp);
+      return *this;
+    }
+
+    ~indexed_list (void)
+    {
+      clear ();
+    }
+
+    GCH_NODISCARD iter   begin   (void)       noexcept { return iter (first_node ());           }
+    GCH_NODISCARD citer  begin   (void) const noexcept { return citer (first_node ());          }
+    GCH_NODISCARD citer  cbegin  (void) const noexcept { return citer (first_node ());          }
+
+    GCH_NODISCARD iter   end     (void)       noexcept { return iter (header ());               }
+    GCH_NODISCARD citer  end     (void) const noexcept { return citer (header ());              }
+    GCH_NODISCARD citer  cend    (void) const noexcept { return citer (header ());              }
+
+    GCH_NODISCARD reverse_iterator       rbegin  (void)       noexcept { return reverse_iterator (end ());        }
+    GCH_NODISCARD const_reverse_iterator rbegin  (void) const noexcept { return const_reverse_iterator (end ());  }
+    GCH_NODISCARD const_reverse_iterator crbegin (void) const noexcept { return const_reverse_iterator (end ());  }
+
+    GCH_NODISCARD reverse_iterator       rend    (void)       noexcept { return reverse_iterator (begin ());      }
+    GCH_NODISCARD const_reverse_iterator rend    (void) const noexcept { return const_reverse_iterator (begin ());}
+    GCH_NODISCARD const_reverse_iterator crend   (void) const noexcept { return const_reverse_iterator (begin ());}
+
+    GCH_NODISCARD reference       front (void)       noexcept { return *begin ();          }
+    GCH_NODISCARD const_reference front (void) const noexcept { return *begin ();          }
+
+    GCH_NODISCARD reference       back  (void)       noexcept { return *std::prev (end ()); }
+    GCH_NODISCARD const_reference back  (void) const noexcept { return *std::prev (end ()); }
+
+    GCH_NODISCARD size_ty size  (void) const noexcept { return subtree_size (root ()); }
+    GCH_NODISCARD bool    empty (void) const noexcept { return root () == nullptr;     }
+
+    GCH_NODISCARD
+    allocator_type
+    get_allocator (void) const noexcept
+    {
+      return allocator_type (m_alloc);
+    }
+
+    // The element at position `k`, or the end if `k == size ()`. O(log n).
+    GCH_NODISCARD
+    iter
+    nth (size_ty k) noexcept
+    {
+      return iter (find_node (k));
+    }
+
+    GCH_NODISCARD
+    citer
+    nth (size_ty k) const noexcept
+    {
+      return citer (find_node (k));
+    }
+
+    // The position of `pos`, or `size ()` for the end. O(log n).
+    GCH_NODISCARD
+    size_ty
+    index_of (citer pos) const noexcept
+    {
+      const node_base *n = pos.m_node;
+      if (n == header ())
+        return size ();
+
+      size_ty k = subtree_size (n->left);
+      for (; n->parent != header (); n = n->parent)
+      {
+        if (n == n->parent->right)
+          k += subtree_size (n->parent->left) + 1;
+      }
+      return k;
+    }
+
+    void
+    clear (void) noexcept
+    {
+      destroy_tree (root ());
+      set_root (nullptr);
+    }
+
+    iter
+    insert (citer pos, const value_ty& val)
+    {
+      return emplace (pos, val);
+    }
+
+    iter
+    insert (citer pos, value_ty&& val)
+    {
+      return emplace (pos, std::move (val));
+    }
+
+    iter
+    insert (citer pos, size_ty count, const value_ty& val)
+    {
+      node_base *t = nullptr;
+      try
+      {
+        for (size_ty i = 0; i < count; ++i)
+          t = merge (t, create_node (val));
+      }
+      catch (...)
+      {
+        destroy_tree (t);
+        throw;
+      }
+      return insert_tree (pos, t);
+    }
+
+    template <typename Iterator,
+              typename = typename std::iterator_traits<Iterator>::iterator_category>
+    iter
+    insert (citer pos, Iterator first, Iterator last)
+    {
+      node_base *t = nullptr;
+      try
+      {
+        for (; first != last; ++first)
+          t = merge (t, create_node (*first));
+      }
+      catch (...)
+      {
+        destroy_tree (t);
+        throw;
+      }
+      return insert_tree (pos, t);
+    }
+
+    iter
+    insert (citer pos, std::initializer_list<value_ty> ilist)
+    {
+      return insert (pos, ilist.begin (), ilist.end ());
+    }
+
+    template <typename ...Args>
+    iter
+    emplace (citer pos, Args&&... args)
+    {
+      return insert_tree (pos, create_node (std::forward<Args> (args)...));
+    }
+
+    iter
+    erase (citer pos)
+    {
+      return erase (pos, std::next (pos));
+    }
+
+    iter
+    erase (citer first, citer last)
+    {
+      destroy_tree (cut (first, last));
+      return iter (last.m_node);
+    }
+
+    void push_back  (const value_ty& val) { emplace (cend (), val);            }
+    void push_back  (value_ty&& val)      { emplace (cend (), std::move (val)); }
+    void push_front (const value_ty& val) { emplace (cbegin (), val);            }
+    void push_front (value_ty&& val)      { emplace (cbegin (), std::move (val)); }
+
+    template <typename ...Args>
+    reference
+    emplace_back (Args&&... args)
+    {
+      return *emplace (cend (), std::forward<Args> (args)...);
+    }
+
+    template <typename ...Args>
+    reference
+    emplace_front (Args&&... args)
+    {
+      return *emplace (cbegin (), std::forward<Args> (args)...);
+    }
+
+    void pop_back  (void) { erase (std::prev (cend ())); }
+    void pop_front (void) { erase (cbegin ());           }
+
+    // `other` may be this list, in which case `pos` may not be in [first, last). O(log n)
+    // regardless of the length of the range.
+    void
+    splice (citer pos, indexed_list& other, citer first, citer last) noexcept
+    {
+      if (first != last)
+        insert_tree (pos, other.cut (first, last));
+    }
+
+    void
+    splice (citer pos, indexed_list& other, citer it) noexcept
+    {
+      splice (pos, other, it, std::next (it));
+    }
+
+    void
+    splice (citer pos, indexed_list& other) noexcept
+    {
+      splice (pos, other, other.cbegin (), other.cend ());
+    }
+
+    void
+    swap (indexed_list& other) noexcept
+    {
+      node_base *r = root ();
+      set_root (other.root ());
+      other.set_root (r);
+
+      using std::swap;
+      swap (m_alloc, other.m_alloc);
+      swap (m_seed, other.m_seed);
+    }
+
+  private:
+    GCH_NODISCARD node_base * root   (void) const noexcept { return m_header.left;                      }
+    GCH_NODISCARD node_base * header (void) const noexcept { return const_cast<node_base *> (&m_header); }
+
+    // the tree hangs off the left of the header, so the header comes after the last element
+    void
+    set_root (node_base *r) noexcept
+    {
+      m_header.left = r;
+      if (r != nullptr)
+        r->parent = &m_header;
+    }
+
+    node_base *
+    first_node (void) const noexcept
+    {
+      node_base *n = header ();
+      while (n->left != nullptr)
+        n = n->left;
+      return n;
+    }
+
+    node_base *
+    find_node (size_ty k) const noexcept
+    {
+      node_base *n = root ();
+      while (n != nullptr)
+      {
+        const size_ty left_size = subtree_size (n->left);
+        if (k < left_size)
+          n = n->left;
+        else if (k == left_size)
+          return n;
+        else
+        {
+          k -= left_size + 1;
+          n  = n->right;
+        }
+      }
+      return header ();
+    }
+
+    iter
+    insert_tree (citer pos, node_base *t) noexcept
+    {
+      if (t == nullptr)
+        return iter (pos.m_node);
+
+      const std::pair<node_base *, node_base *> halves = split (root (), index_of (pos));
+      node_base *first = t;
+      while (first->left != nullptr)
+        first = first->left;
+
+      set_root (merge (merge (halves.first, t), halves.second));
+      return iter (first);
+    }
+
+    // detaches [first, last) and returns it as a tree of its own
+    node_base *
+    cut (citer first, citer last) noexcept
+    {
+      const size_ty i = index_of (first);
+      const size_ty j = index_of (last);
+
+      const std::pair<node_base *, node_base *> back  = split (root (), j);
+      const std::pair<node_base *, node_base *> front = split (back.first, i);
+      set_root (merge (front.first, back.second));
+      if (front.second != nullptr)
+        front.second->parent = nullptr;
+      return front.second;
+    }
+
+    template <typename ...Args>
+    node_base *
+    create_node (Args&&... args)
+    {
+      node *n = node_alloc_traits::allocate (m_alloc, 1);
+      try
+      {
+        node_alloc_traits::construct (m_alloc, n, std::forward<Args> (args)...);
+      }
+      catch (...)
+      {
+        node_alloc_traits::deallocate (m_alloc, n, 1);
+        throw;
+      }
+      n->size     = 1;
+      n->priority = next_priority ();
+      return n;
+    }
+
+    void
+    destroy_tree (node_base *n) noexcept
+    {
+      if (n == nullptr)
+        return;
+
+      destroy_tree (n->left);
+      destroy_tree (n->right);
+      node *p = static_cast<node *> (n);
+      node_alloc_traits::destroy (m_alloc, p);
+      node_alloc_traits::deallocate (m_alloc, p, 1);
+    }
+
+    std::uint32_t
+    next_priority (void) noexcept
+    {
+      // xorshift
+      m_seed ^= m_seed << 13;
+      m_seed ^= m_seed >> 17;
+      m_seed ^= m_seed << 5;
+      return m_seed;
+    }
+
+    static size_ty
+    subtree_size (const node_base *n) noexcept
+    {
+      return (n == nullptr) ? 0 : n->size;
+    }
+
+    static void
+    update (node_base *n) noexcept
+    {
+      n->size = subtree_size (n->left) + subtree_size (n->right) + 1;
+      if (n->left != nullptr)
+        n->left->parent = n;
+      if (n->right != nullptr)
+        n->right->parent = n;
+    }
+
+    // joins two trees where every element of `a` comes before every element of `b`
+    static node_base *
+    merge (node_base *a, node_base *b) noexcept
+    {
+      if (a == nullptr)
+        return b;
+      if (b == nullptr)
+        return a;
+
+      if (b->priority < a->priority)
+      {
+        a->right = merge (a->right, b);
+        update (a);
+        return a;
+      }
+      b->left = merge (a, b->left);
+      update (b);
+      return b;
+    }
+
+    // splits off the first `k` elements of `n`
+    static std::pair<node_base *, node_base *>
+    split (node_base *n, size_ty k) noexcept
+    {
+      if (n == nullptr)
+        return { nullptr, nullptr };
+
+      const size_ty left_size = subtree_size (n->left);
+      if (left_size < k)
+      {
+        const std::pair<node_base *, node_base *> rest = split (n->right, k - left_size - 1);
+        n->right = rest.first;
+        update (n);
+        return { n, rest.second };
+      }
+      const std::pair<node_base *, node_base *> rest = split (n->left, k);
+      n->left = rest.second;
+      update (n);
+      return { rest.first, n };
+    }
+
+    static node_base *
+    next_node (node_base *n) noexcept
+    {
+      if (n->right != nullptr)
+      {
+        n = n->right;
+        while (n->left != nullptr)
+          n = n->left;
+        return n;
+      }
+
+      node_base *p = n->parent;
+      while (n == p->right)
+      {
+        n = p;
+        p = p->parent;
+      }
+      return p;
+    }
+
+    static node_base *
+    prev_node (node_base *n) noexcept
+    {
+      if (n->left != nullptr)
+      {
+        n = n->left;
+        while (n->right != nullptr)
+          n = n->right;
+        return n;
+      }
+
+      node_base *p = n->parent;
+      while (n == p->left)
+      {
+        n = p;
+        p = p->parent;
+      }
+      return p;
+    }
+
+    node_base      m_header;
+    node_allocator m_alloc;
+    std::uint32_t  m_seed = 2463534242U;
+  };
+
+  template <typename T, typename Allocator>
+  void swap (indexed_list<T, Allocator>& lhs, indexed_list<T, Allocator>& rhs) noexcept
+  {
+    lhs.swap (rhs);
+  }
+
+  template <typename T, std::size_t N, typename Container = indexed_list<T>>
+  class indexed_list_partition;
+
+  // A reference to subrange `index ()` of an `indexed_list_partition`.
+  template <typename Partition>
+  class indexed_subrange
+  {
+  public:
+    using partition_type          = Partition;
+    using nonconst_partition_type = typename std::remove_const<Partition>::type;
+
+    using container_type  = typename nonconst_partition_type::container_type;
+    using iterator        = typename std::conditional<std::is_const<Partition>::value,
+                                                      typename container_type::const_iterator,
+                                                      typename container_type::iterator>::type;
+    using const_iterator  = typename container_type::const_iterator;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using reference       = typename std::iterator_traits<iterator>::reference;
+    using const_reference = typename container_type::const_reference;
+    using size_type       = typename container_type::size_type;
+    using difference_type = typename container_type::difference_type;
+    using value_type      = typename container_type::value_type;
+
+  private:
+    using iter     = iterator;
+    using citer    = const_iterator;
+    using riter    = reverse_iterator;
+    using criter   = const_reverse_iterator;
+    using ref      = reference;
+    using cref     = const_reference;
+    using size_ty  = size_type;
+    using diff_ty  = difference_type;
+    using value_ty = value_type;
+
+  public:
+    indexed_subrange            (void)                        = delete;
+    indexed_subrange            (const indexed_subrange&)     = default;
+    indexed_subrange            (indexed_subrange&&) noexcept = default;
+    indexed_subrange& operator= (const indexed_subrange&)     = default;
+    indexed_subrange& operator= (indexed_subrange&&) noexcept = default;
+    ~indexed_subrange           (void)                        = default;
+
+    indexed_subrange (partition_type& p, std::size_t index) noexcept
+      : m_partition (&p),
+        m_index     (index)
+    { }
+
+    // conversion to a reference to a const partition
+    template <typename NonConst,
+              typename = typename std::enable_if<std::is_same<nonconst_partition_type,
+                                                              NonConst>::value>::type>
+    /* implicit */ indexed_subrange (const indexed_subrange<NonConst>& other) noexcept
+      : m_partition (&other.get_partition ()),
+        m_index     (other.index ())
+    { }
+
+    GCH_NODISCARD partition_type& get_partition (void) const noexcept { return *m_partition; }
+    GCH_NODISCARD std::size_t     index         (void) const noexcept { return m_index;      }
+
+    GCH_NODISCARD iter   begin   (void) const noexcept { return m_partition->subrange_iter (m_index);      }
+    GCH_NODISCARD citer  cbegin  (void) const noexcept { return m_partition->subrange_iter (m_index);      }
+
+    GCH_NODISCARD iter   end     (void) const noexcept { return m_partition->subrange_iter (m_index + 1);  }
+    GCH_NODISCARD citer  cend    (void) const noexcept { return m_partition->subrange_iter (m_index + 1);  }
+
+    GCH_NODISCARD riter  rbegin  (void) const noexcept { return riter (end ());                            }
+    GCH_NODISCARD criter crbegin (void) const noexcept { return criter (cend ());                          }
+
+    GCH_NODISCARD riter  rend    (void) const noexcept { return riter (begin ());                          }
+    GCH_NODISCARD criter crend   (void) const noexcept { return criter (cbegin ());                        }
+
+    GCH_NODISCARD ref    front   (void) const noexcept { return *begin ();                                 }
+    GCH_NODISCARD ref    back    (void) const noexcept { return *std::prev (end ());                       }
+
+    GCH_NODISCARD
+    size_ty
+    size (void) const noexcept
+    {
+      return static_cast<size_ty> (m_partition->get_offset (m_index + 1)
+                                   - m_partition->get_offset (m_index));
+    }
+
+    GCH_NODISCARD
+    bool
+    empty (void) const noexcept
+    {
+      return size () == 0;
+    }
+
+    // The element at position `k` of this subrange, or the end if `k == size ()`. O(log n).
+    GCH_NODISCARD
+    iter
+    nth (size_ty k) const noexcept
+    {
+      return m_partition->subrange_nth (m_index, k);
+    }
+
+    // The position of `pos` in this subrange. O(log n).
+    GCH_NODISCARD
+    size_ty
+    index_of (citer pos) const noexcept
+    {
+      return m_partition->data_index_of (pos)
+           - static_cast<size_ty> (m_partition->get_offset (m_index));
+    }
+
+    subrange_view<iter>
+    view (void) const
+    {
+      return { begin (), end () };
+    }
+
+    void clear (void) const
+    {
+      erase (cbegin (), cend ());
+    }
+
+    iter insert (const citer pos, const value_ty& lv) const
+    {
+      return m_partition->subrange_insert (m_index, pos, lv);
+    }
+
+    iter insert (const citer pos, value_ty&& rv) const
+    {
+      return m_partition->subrange_insert (m_index, pos, std::move (rv));
+    }
+
+    iter insert (const citer pos, size_ty count, const value_ty& val) const
+    {
+      return m_partition->subrange_insert (m_index, pos, count, val);
+    }
+
+    template <typename Iterator>
+    iter insert (const citer pos, Iterator first, Iterator last) const
+    {
+      return m_partition->subrange_insert (m_index, pos, first, last);
+    }
+
+    iter insert (const citer pos, std::initializer_list<value_ty> ilist) const
+    {
+      return m_partition->subrange_insert (m_index, pos, ilist);
+    }
+
+    template <typename ...Args>
+    iter emplace (const citer pos, Args&&... args) const
+    {
+      return m_partition->subrange_emplace (m_index, pos, std::forward<Args> (args)...);
+    }
+
+    iter erase (const citer pos) const
+    {
+      return m_partition->subrange_erase (m_index, pos, std::next (pos));
+    }
+
+    iter erase (const citer first, const citer last) const
+    {
+      return m_partition->subrange_erase (m_index, first, last);
+    }
+
+    void push_back (const value_ty& val) const
+    {
+      insert (cend (), val);
+    }
+
+    void push_back (value_ty&& val) const
+    {
+      insert (cend (), std::move (val));
+    }
+
+    void push_front (const value_ty& val) const
+    {
+      insert (cbegin (), val);
+    }
+
+    void push_front (value_ty&& val) const
+    {
+      insert (cbegin (), std::move (val));
+    }
+
+    template <typename ...Args>
+    ref emplace_back (Args&&... args) const
+    {
+      return *emplace (cend (), std::forward<Args> (args)...);
+    }
+
+    template <typename ...Args>
+    ref emplace_front (Args&&... args) const
+    {
+      return *emplace (cbegin (), std::forward<Args> (args)...);
+    }
+
+    void pop_back (void) const
+    {
+      erase (std::prev (cend ()));
+    }
+
+    void pop_front (void) const
+    {
+      erase (cbegin ());
+    }
+
+    void resize (size_ty count) const
+    {
+      resize (count, { });
+    }
+
+    void resize (size_ty count, const value_ty& val) const
+    {
+      if (count > size ())
+        insert (cend (), count - size (), val);
+      else if (count < size ())
+        erase (nth (count), cend ());
+    }
+
+    // Moves [first, last) out of `other` to before `pos`. `other` may be this subrange or belong
+    // to another partition, in which case the allocators must compare equal. O(log n) regardless
+    // of the length of the range.
+    void splice (const citer pos, const indexed_subrange& other,
+                 const citer first, const citer last) const
+    {
+      m_partition->subrange_splice (m_index, pos, other.get_partition (), other.index (),
+                                    first, last);
+    }
+
+    void splice (const citer pos, const indexed_subrange& other, const citer it) const
+    {
+      splice (pos, other, it, std::next (it));
+    }
+
+    void splice (const citer pos, const indexed_subrange& other) const
+    {
+      splice (pos, other, other.cbegin (), other.cend ());
+    }
+
+    iter advance_begin (diff_ty change) const
+    {
+      return m_partition->advance_begin (m_index, change);
+    }
+
+    iter advance_end (diff_ty change) const
+    {
+      return m_partition->advance_end (m_index, change);
+    }
+
+  private:
+    partition_type *m_partition;
+    std::size_t     m_index;
+  };
+
+  // A list partition where elements can be found by position. The boundaries are stored as
+  // offsets, as in `vector_partition`, and the elements in an `indexed_list`, so finding the
+  // beginning of a subrange or the element at a position is O(log n). Moving a boundary only
+  // changes the offsets.
+  template <typename T, std::size_t N, typename Container>
+  class indexed_list_partition
+  {
+    template <typename>
+    friend class indexed_subrange;
+
+  public:
+    using container_type = Container;
+
+    using data_iter    = typename container_type::iterator;
+    using data_citer   = typename container_type::const_iterator;
+    using data_riter   = typename container_type::reverse_iterator;
+    using data_criter  = typename container_type::const_reverse_iterator;
+    using data_ref     = typename container_type::reference;
+    using data_cref    = typename container_type::const_reference;
+    using data_size_t  = typename container_type::size_type;
+    using data_diff_t  = typename container_type::difference_type;
+    using data_val_t   = typename container_type::value_type;
+    using data_alloc_t = typename container_type::allocator_type;
+
+    using subrange_type       = indexed_subrange<indexed_list_partition>;
+    using const_subrange_type = indexed_subrange<const indexed_list_partition>;
+
+    using subrange_view_type       = subrange_view<data_iter>;
+    using const_subrange_view_type = subrange_view<data_citer>;
+
+    static_assert (0 < N, "indexed_list_partition needs at least one subrange.");
+
+    indexed_list_partition            (void)                              = default;
+    indexed_list_partition            (const indexed_list_partition&)     = default;
+    indexed_list_partition            (indexed_list_partition&&) noexcept = default;
+    indexed_list_partition& operator= (const indexed_list_partition&)     = default;
+    indexed_list_partition& operator= (indexed_list_partition&&) noexcept = default;
+    ~indexed_list_partition           (void)                              = default;
+
+    explicit indexed_list_partition (const data_alloc_t& alloc)
+      : m_container (alloc)
+    { }
+
+    GCH_NODISCARD static constexpr std::size_t size (void) noexcept { return N; }
+
+    GCH_NODISCARD
+    subrange_type
+    operator[] (std::size_t idx) noexcept
+    {
+      return { *this, idx };
+    }
+
+    GCH_NODISCARD
+    const_subrange_type
+    operator[] (std::size_t idx) const noexcept
+    {
+      return { *this, idx };
+    }
+
+    GCH_NODISCARD
+    subrange_type
+    at (std::size_t idx)
+    {
+      check_index (idx);
+      return { *this, idx };
+    }
+
+    GCH_NODISCARD
+    const_subrange_type
+    at (std::size_t idx) const
+    {
+      check_index (idx);
+      return { *this, idx };
+    }
+
+    data_iter   data_begin   (void)       noexcept { return m_container.begin ();   }
+    data_citer  data_begin   (void) const noexcept { return m_container.begin ();   }
+    data_citer  data_cbegin  (void) const noexcept { return m_container.cbegin ();  }
+
+    data_iter   data_end     (void)       noexcept { return m_container.end ();     }
+    data_citer  data_end     (void) const noexcept { return m_container.end ();     }
+    data_citer  data_cend    (void) const noexcept { return m_container.cend ();    }
+
+    data_riter  data_rbegin  (void)       noexcept { return m_container.rbegin ();  }
+    data_criter data_rbegin  (void) const noexcept { return m_container.rbegin ();  }
+    data_criter data_crbegin (void) const noexcept { return m_container.crbegin (); }
+
+    data_riter  data_rend    (void)       noexcept { return m_container.rend ();    }
+    data_criter data_rend    (void) const noexcept { return m_container.rend ();    }
+    data_criter data_crend   (void) const noexcept { return m_container.crend ();   }
+
+    data_size_t data_size (void) const noexcept { return m_container.size (); }
+    GCH_NODISCARD bool data_empty (void) const noexcept { return m_container.empty (); }
+
+    data_alloc_t get_allocator (void) const noexcept
+    {
+      return m_container.get_allocator ();
+    }
+
+    // The element at position `k` of the data. O(log n).
+    GCH_NODISCARD data_iter  data_nth (data_size_t k)       noexcept { return m_container.nth (k); }
+    GCH_NODISCARD data_citer data_nth (data_size_t k) const noexcept { return m_container.nth (k); }
+
+    // The position of `pos` in the data. O(log n).
+    GCH_NODISCARD
+    data_size_t
+    data_index_of (data_citer pos) const noexcept
+    {
+      return m_container.index_of (pos);
+    }
+
+    // Returns the index of the subrange containing `pos` in O(log n + log N). Where several
+    // subranges begin at `pos` (i.e. some of them are empty), the last one is returned.
+    GCH_NODISCARD
+    std::size_t
+    find_subrange (data_citer pos) const noexcept
+    {
+      const data_diff_t off = static_cast<data_diff_t> (m_container.index_of (pos));
+      return static_cast<std::size_t> (std::upper_bound (m_offsets.begin (), m_offsets.end (), off)
+                                       - m_offsets.begin ()) - 1;
+    }
+
+    // Same semantics as `vector_partition`. Moving a boundary past other boundaries pushes them
+    // along with it. Only the offsets change, so this is O(N + log n).
+    data_iter
+    advance_begin (std::size_t idx, data_diff_t change)
+    {
+      if (idx == 0)
+        throw std::out_of_range ("the beginning of the first subrange cannot be moved");
+      check_index (idx);
+
+      data_diff_t& offset = m_offsets[idx];
+
+      // first case: past end, second case: past begin
+      if (((change > 0) && (change > static_cast<data_diff_t> (m_container.size ()) - offset))
+          || ((change < 0) && (-change > offset)))
+        throw std::out_of_range ("requested change of subrange offset is out of range");
+
+      offset += change;
+      for (std::size_t i = idx + 1; i < N && m_offsets[i] < offset; ++i)
+        m_offsets[i] = offset;
+
+      for (std::size_t i = idx - 1; 0 < i && offset < m_offsets[i]; --i)
+        m_offsets[i] = offset;
+
+      return subrange_iter (idx);
+    }
+
+    data_iter
+    advance_end (std::size_t idx, data_diff_t change)
+    {
+      return advance_begin (idx + 1, change);
+    }
+
+    // O(log n), one `nth` lookup for each end
+    subrange_view_type
+    get_subrange_view (std::size_t idx)
+    {
+      return { subrange_iter (idx), subrange_iter (idx + 1) };
+    }
+
+    const_subrange_view_type
+    get_subrange_view (std::size_t idx) const
+    {
+      return { subrange_iter (idx), subrange_iter (idx + 1) };
+    }
+
+    // The boundaries are kept as offsets, so each view looks up its ends with `nth`. Neighbouring
+    // views share a boundary, which is looked up once: O(N log n) in all.
+    partition_view<indexed_list_partition, N>
+    get_partition_view (void)
+    {
+      return partition_view<indexed_list_partition, N> (make_views (*this));
+    }
+
+    partition_view<const indexed_list_partition, N>
+    get_partition_view (void) const
+    {
+      return partition_view<const indexed_list_partition, N> (make_views (*this));
+    }
+
+    void
+    swap (indexed_list_partition& other) noexcept
+    {
+      using std::swap;
+      swap (m_container, other.m_container);
+      swap (m_offsets, other.m_offsets);
+    }
+
+  private:
+    template <typename Self>
+    static
+    std::array<partition_subrange_view_t<Self>, N>
+    make_views (Self& self)
+    {
+      std::array<partition_subrange_view_t<Self>, N> ret;
+      auto first = self.subrange_iter (0);
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        auto last = self.subrange_iter (i + 1);
+        ret[i] = { first, last };
+        first = last;
+      }
+      return ret;
+    }
+
+    void
+    check_index (std::size_t idx) const
+    {
+      if (idx >= N)
+        throw std::out_of_range ("subrange index is out of range");
+    }
+
+    // subrange `N` begins at the end of the container
+    data_diff_t
+    get_offset (std::size_t idx) const noexcept
+    {
+      return idx < N ? m_offsets[idx] : static_cast<data_diff_t> (m_container.size ());
+    }
+
+    data_iter  subrange_iter (std::size_t idx)       noexcept { return m_container.nth (static_cast<data_size_t> (get_offset (idx))); }
+    data_citer subrange_iter (std::size_t idx) const noexcept { return m_container.nth (static_cast<data_size_t> (get_offset (idx))); }
+
+    data_iter
+    subrange_nth (std::size_t idx, data_size_t k) noexcept
+    {
+      return m_container.nth (static_cast<data_size_t> (get_offset (idx)) + k);
+    }
+
+    data_citer
+    subrange_nth (std::size_t idx, data_size_t k) const noexcept
+    {
+      return m_container.nth (static_cast<data_size_t> (get_offset (idx)) + k);
+    }
+
+    void
+    add_to_offsets (std::size_t first, data_diff_t change) noexcept
+    {
+      for (std::size_t i = first; i < N; ++i)
+        m_offsets[i] += change;
+    }
+
+    template <typename ...Args>
+    data_iter
+    subrange_insert (std::size_t idx, data_citer pos, Args&&... args)
+    {
+      const data_size_t old_size = m_container.size ();
+      data_iter ret = m_container.insert (pos, std::forward<Args> (args)...);
+      add_to_offsets (idx + 1, static_cast<data_diff_t> (m_container.size () - old_size));
+      return ret;
+    }
+
+    template <typename ...Args>
+    data_iter
+    subrange_emplace (std::size_t idx, data_citer pos, Args&&... args)
+    {
+      data_iter ret = m_container.emplace (pos, std::forward<Args> (args)...);
+      add_to_offsets (idx + 1, 1);
+      return ret;
+    }
+
+    data_iter
+    subrange_erase (std::size_t idx, data_citer first, data_citer last)
+    {
+      const data_size_t old_size = m_container.size ();
+      data_iter ret = m_container.erase (first, last);
+      add_to_offsets (idx + 1, -static_cast<data_diff_t> (old_size - m_container.size ()));
+      return ret;
+    }
+
+    // The range leaves subrange `src` of `from` and joins subrange `idx`. Within one partition
+    // only the boundaries between the two move.
+    void
+    subrange_splice (std::size_t idx, data_citer pos, indexed_list_partition& from,
+                     std::size_t src, data_citer first, data_citer last) noexcept
+    {
+      const data_diff_t count = static_cast<data_diff_t> (from.m_container.index_of (last)
+                                                          - from.m_container.index_of (first));
+      // if the range directly follows `pos` it is already in place
+      if (pos != first)
+        m_container.splice (pos, from.m_container, first, last);
+      from.add_to_offsets (src + 1, -count);
+      add_to_offsets (idx + 1, count);
+    }
+
+    container_type                m_container;
+    std::array<data_diff_t, N>    m_offsets { };
+  };
+
+  template <typename T, std::size_t N, typename Container>
+  void swap (indexed_list_partition<T, N, Container>& lhs,
+             indexed_list_partition<T, N, Container>& rhs) noexcept
+  {
+    lhs.swap (rhs);
+  }
+
+}
+
+#endif // PARTITION_INDEXED_LIST_PARTITION_HPP
@@ -12,8 +12,13 @@
 
 #include "partition.hpp"
 
+#include <algorithm>
+#include <array>
 #include <stdexcept>
 #include <list>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace gch
 {
@@ -21,6 +26,14 @@ namespace gch
   template <typename T, std::size_t N, typename Container = std::list<T>>
   class list_partition;
 
+  namespace detail
+  {
+
+    // defined in parallel.hpp, where the algorithms that take a list apart live
+    struct list_partition_access;
+
+  } // namespace detail
+
   template <typename T, std::size_t N, typename Container, std::size_t Index>
   class partition_subrange<list_partition<T, N, Container>, Index,
     typename std::enable_if<! (0 <= Index || Index <= N || Index == partition_base_index)>::type>
@@ -68,6 +81,8 @@ namespace gch
 
   protected:
     using next_type::m_container;
+    using next_type::m_sizes;
+    using next_type::relocate_nodes;
 
     partition_subrange            (void)                          = default;
     partition_subrange            (const partition_subrange&)     = default;
@@ -97,18 +112,20 @@ namespace gch
     }
 
     template <std::size_t M, typename ...Subranges>
-    constexpr
     partition_subrange (const partition_subrange<list_partition<T, M, Container>, 0>& other,
                         Subranges&&... subranges)
       : next_type (next_subrange (other), std::forward<Subranges> (subranges)...)
-    { }
+    {
+      m_sizes[0] = other.size ();
+    }
 
     template <std::size_t M, typename ...Subranges>
-    constexpr
     partition_subrange (partition_subrange<list_partition<T, M, Container>, 0>&& other,
                         Subranges&&... subranges)
       : next_type (next_subrange (other), std::forward<Subranges> (subranges)...)
-    { }
+    {
+      m_sizes[0] = other.size ();
+    }
 
     template <std::size_t M, typename ...Subranges>
     constexpr
@@ -186,11 +203,11 @@ namespace gch
     GCH_NODISCARD ref&   back    (void)       noexcept { return *(--end ());          }
     GCH_NODISCARD cref&  back    (void) const noexcept { return *(--cend ());         }
 
-    GCH_NODISCARD GCH_CPP17_CONSTEXPR
+    GCH_NODISCARD
     size_ty
     size (void) const noexcept
     {
-      return static_cast<size_ty> (std::distance (cbegin (), cend ()));
+      return m_sizes[0];
     }
 
     GCH_NODISCARD
@@ -209,50 +226,65 @@ namespace gch
     iter
     insert (const citer pos, const value_ty& lv)
     {
-      return m_container.insert (pos, lv);
+      iter ret = m_container.insert (pos, lv);
+      ++m_sizes[0];
+      return ret;
     }
 
     iter
     insert (const citer pos, value_ty&& rv)
     {
-      return m_container.insert (pos, std::move (rv));
+      iter ret = m_container.insert (pos, std::move (rv));
+      ++m_sizes[0];
+      return ret;
     }
 
     iter
     insert (const citer pos, size_ty count, const value_ty& val)
     {
-      return m_container.insert (pos, count, val);
+      iter ret = m_container.insert (pos, count, val);
+      m_sizes[0] += count;
+      return ret;
     }
 
     template <typename Iterator>
     iter
     insert (const citer pos, Iterator first, Iterator last)
     {
-      return m_container.insert (pos, first, last);
+      iter ret = m_container.insert (pos, first, last);
+      m_sizes[0] += static_cast<size_ty> (std::distance (citer (ret), pos));
+      return ret;
     }
 
     iter
     insert (const citer pos, std::initializer_list<value_ty> ilist)
     {
-      return m_container.insert (pos, ilist);
+      iter ret = m_container.insert (pos, ilist);
+      m_sizes[0] += ilist.size ();
+      return ret;
     }
 
     template <typename ...Args>
     iter
     emplace (const citer pos, Args&&... args)
     {
-      return m_container.emplace (pos, std::forward<Args> (args)...);
+      iter ret = m_container.emplace (pos, std::forward<Args> (args)...);
+      ++m_sizes[0];
+      return ret;
     }
 
     iter
     erase (const citer pos)
     {
-      return m_container.erase (pos);
+      iter ret = m_container.erase (pos);
+      --m_sizes[0];
+      return ret;
     }
 
     iter
     erase (const citer first, const citer last)
     {
+      m_sizes[0] -= static_cast<size_ty> (std::distance (first, last));
       return m_container.erase (first, last);
     }
 
@@ -285,12 +317,14 @@ namespace gch
     push_front (const value_ty& val)
     {
       m_container.push_front (val);
+      ++m_sizes[0];
     }
 
     void
     push_front (value_ty&& val)
     {
       m_container.push_front (std::move (val));
+      ++m_sizes[0];
     }
 
     template <typename ...Args>
@@ -304,34 +338,24 @@ namespace gch
     pop_front (void)
     {
       m_container.pop_front ();
+      --m_sizes[0];
     }
 
-    template <std::size_t M, std::size_t J>
+    template <std::size_t M, std::size_t J, typename std::enable_if<(M != N)>::type * = nullptr>
     void
     swap (partition_subrange<list_partition<T, M, Container>, J>& other)
     {
-      if (&other == this)
-        return;
-
-      iter tmp_first = begin ();
-
-      other.m_container.splice (other.cend (), std::move (m_container), cbegin (), cend ());
-      m_container.splice (cend (), std::move (other.m_container), other.cbegin (), tmp_first);
-
-      other.set_first (tmp_first);
+      swap_between (other);
     }
 
-    template <std::size_t M>
+    template <std::size_t J>
     void
-    swap (partition_subrange<list_partition<T, M, Container>, 0>& other)
+    swap (partition_subrange<partition_type, J>& other)
     {
-      if (&other == this)
-        return;
-
-      iter tmp_first = begin ();
-
-      other.m_container.splice (other.cend (), std::move (m_container), cbegin (), cend ());
-      m_container.splice (cend (), std::move (other.m_container), other.cbegin (), tmp_first);
+      if (&other.m_container == &m_container)
+        swap_in_place (other);
+      else
+        swap_between (other);
     }
 
     template <std::size_t M, std::size_t J, typename ...Args>
@@ -355,6 +379,9 @@ namespace gch
       tmp1.merge (std::move (tmp2), std::forward<Args> (args)...);
       m_container.splice (cend (), tmp1);
       other.set_first (other.end ());
+
+      m_sizes[0] += other.size ();
+      other.m_sizes[J] = 0;
     }
 
     template <std::size_t M, std::size_t J, typename ...Args>
@@ -369,8 +396,14 @@ namespace gch
     void
     splice (citer pos, partition_subrange<list_partition<T, M, Container>, J>&& other)
     {
-      m_container.splice (pos, std::move (other.m_container), other.cbegin (), other.cend ());
+      if (other.empty ())
+        return;
+
+      // if `other` directly follows this subrange its elements are already in place
+      if (pos != other.cbegin ())
+        m_container.splice (pos, std::move (other.m_container), other.cbegin (), other.cend ());
       other.set_first (other.end ());
+      transfer_size (other, other.size ());
     }
 
     template <std::size_t M, std::size_t J>
@@ -381,6 +414,7 @@ namespace gch
       citer new_other_front = std::next (cit);
       m_container.splice (pos, std::move (other.m_container), cit);
       other.propagate_first_left (cit, get_iter (new_other_front));
+      transfer_size (other, 1);
     }
 
     template <std::size_t M, std::size_t J>
@@ -388,8 +422,15 @@ namespace gch
     splice (citer pos, partition_subrange<list_partition<T, M, Container>, J>&& other,
             citer first, citer last)
     {
-      m_container.splice (pos, std::move (other.m_container), first, last);
+      if (first == last)
+        return;
+
+      const size_ty count = static_cast<size_ty> (std::distance (first, last));
+      // see above
+      if (pos != first)
+        m_container.splice (pos, std::move (other.m_container), first, last);
       other.propagate_first_left (first, get_iter (last));
+      transfer_size (other, count);
     }
 
     size_ty
@@ -405,9 +446,9 @@ namespace gch
       container_type tmp;
       tmp.splice (tmp.end (), std::move (m_container), cbegin (), cend ());
 
-      size_ty original_size = tmp.size ();
       tmp.remove_if (p);
-      size_ty num_removed = original_size - tmp.size ();
+      size_ty num_removed = m_sizes[0] - tmp.size ();
+      m_sizes[0] = tmp.size ();
 
       m_container.splice (cend (), tmp);
 
@@ -421,6 +462,7 @@ namespace gch
       container_type tmp;
       tmp.splice (tmp.end (), std::move (m_container), cbegin (), cend ());
       tmp.unique (std::forward<Args> (args)...);
+      m_sizes[0] = tmp.size ();
       m_container.splice (cend (), tmp);
     }
 
@@ -434,6 +476,20 @@ namespace gch
       m_container.splice (cend (), tmp);
     }
 
+    // Moves the elements into new nodes, allocated one after another in traversal order, so that
+    // walking the subrange walks memory in order again after heavy splicing and erasing. If an
+    // allocation throws, the subrange is left as it was, unless the elements are move-only and
+    // may throw when moved. Iterators and references to the elements of this subrange are
+    // invalidated.
+    void
+    defragment (void)
+    {
+      if (empty ())
+        return;
+
+      m_container.erase (cbegin (), relocate_nodes (begin (), end ()));
+    }
+
     void
     resize (size_ty count)
     {
@@ -482,12 +538,21 @@ namespace gch
     iter
     advance_begin (diff_ty) = delete;
 
+    iter
+    advance_begin_unchecked (diff_ty) = delete;
+
     iter
     advance_end (diff_ty change)
     {
       return next_subrange (*this).advance_begin (change);
     }
 
+    iter
+    advance_end_unchecked (diff_ty change) noexcept
+    {
+      return next_subrange (*this).advance_begin_unchecked (change);
+    }
+
   protected:
     void
     partition_swap (partition_subrange& other)
@@ -496,9 +561,82 @@ namespace gch
       next_type::partition_swap (other);
     }
 
+    void
+    assign_firsts (const std::array<size_ty, N>& sizes)
+    {
+      next_type::assign_first (std::next (m_container.begin (), static_cast<diff_ty> (sizes[0])),
+                               sizes);
+    }
+
   private:
-    static void set_first            (iter)        noexcept { }
-    static void propagate_first_left (citer, iter) noexcept { }
+    static void set_first            (iter)                    noexcept { }
+    static void propagate_first_left (citer, iter)             noexcept { }
+    static void carry_first_left     (size_ty, size_ty, iter) noexcept { }
+
+    iter
+    get_iter (citer cit)
+    {
+      return m_container.erase (cit, cit);
+    }
+
+    template <std::size_t M, std::size_t J>
+    void
+    swap_between (partition_subrange<list_partition<T, M, Container>, J>& other)
+    {
+      iter tmp_first = begin ();
+
+      other.m_container.splice (other.cend (), std::move (m_container), cbegin (), cend ());
+      m_container.splice (cend (), std::move (other.m_container), other.cbegin (), tmp_first);
+
+      other.set_first (tmp_first);
+      std::swap (m_sizes[0], other.m_sizes[J]);
+    }
+
+    template <std::size_t M>
+    void
+    swap_between (partition_subrange<list_partition<T, M, Container>, 0>& other)
+    {
+      iter tmp_first = begin ();
+
+      other.m_container.splice (other.cend (), std::move (m_container), cbegin (), cend ());
+      m_container.splice (cend (), std::move (other.m_container), other.cbegin (), tmp_first);
+      std::swap (m_sizes[0], other.m_sizes[0]);
+    }
+
+    // Both subranges are in the same list, so just relink the nodes and fix up the first
+    // iterators of the subranges from here through J.
+    template <std::size_t J, typename std::enable_if<(0 < J)>::type * = nullptr>
+    void
+    swap_in_place (partition_subrange<partition_type, J>& other)
+    {
+      const iter a_first = begin ();
+      const iter a_last  = end ();
+      const iter b_first = other.begin ();
+      const iter b_last  = other.end ();
+
+      // move b in front of a, then a behind whatever was between them (if anything)
+      if (a_first != b_first)
+        m_container.splice (a_first, m_container, b_first, b_last);
+      if (a_last != b_first)
+        m_container.splice (b_last, m_container, a_first, a_last);
+
+      next_subrange (*this).template replace_first_through<J> (b_first,
+                                                               a_first == a_last ? b_last : a_first);
+      std::swap (m_sizes[0], m_sizes[J]);
+    }
+
+    template <std::size_t J, typename std::enable_if<(J == 0)>::type * = nullptr>
+    void
+    swap_in_place (partition_subrange<partition_type, J>&) noexcept { }
+
+    template <std::size_t M, std::size_t J>
+    void
+    transfer_size (partition_subrange<list_partition<T, M, Container>, J>& other,
+                   size_ty count) noexcept
+    {
+      other.m_sizes[J] -= count;
+      m_sizes[0]       += count;
+    }
 
     std::pair<citer, size_ty>
     resize_pos (const size_ty count) const
@@ -556,6 +694,8 @@ namespace gch
 
   protected:
     using next_type::m_container;
+    using next_type::m_sizes;
+    using next_type::relocate_nodes;
 
 //  partition_subrange            (void)                          = impl;
 //  partition_subrange            (const partition_subrange&)     = impl;
@@ -569,15 +709,19 @@ namespace gch
         m_first (m_container.end ())
     { }
 
+    // the casts keep the concatenation constructors of `next_type` out of overload resolution
     partition_subrange (const partition_subrange& other)
-      : next_type (other),
+      : next_type (static_cast<const next_type&> (other)),
         m_first (std::next (m_container.begin (),
                             std::distance (other.m_container.begin (), other.begin ())))
     { }
 
+    // Iterators to the elements are carried over by the move, but an empty subrange at the back
+    // points at the end of the moved-from list, so it has to be pointed at our end instead.
     partition_subrange (partition_subrange&& other)
-      : next_type (std::move (other)),
-        m_first (other.m_first)
+      : next_type (static_cast<next_type&&> (other)),
+        m_first ((other.m_first == other.m_container.end ()) ? m_container.end ()
+                                                               : other.m_first)
     { }
 
     partition_subrange&
@@ -602,13 +746,14 @@ namespace gch
 
     template <std::size_t M, std::size_t J, typename ...Subranges,
       typename std::enable_if<(J < M)>::type * = nullptr>
-    constexpr
     partition_subrange (const partition_subrange<list_partition<T, M, Container>, J>& other,
                         Subranges&&... subranges)
       : next_type (next_subrange (other), std::forward<Subranges> (subranges)...),
         m_first (std::next (m_container.begin (),
                             std::distance (other.m_container.begin (), other.begin ())))
-    { }
+    {
+      m_sizes[Index] = other.size ();
+    }
 
     template <std::size_t M, typename ...Subranges>
     partition_subrange (const partition_subrange<list_partition<T, M, Container>, M>& other,
@@ -621,12 +766,13 @@ namespace gch
 
     template <std::size_t M, std::size_t J, typename ...Subranges,
               typename std::enable_if<(J < M)>::type * = nullptr>
-    constexpr
     partition_subrange (partition_subrange<list_partition<T, M, Container>, J>&& other,
                              Subranges&&... subranges)
       : next_type (next_subrange (other), std::forward<Subranges> (subranges)...),
         m_first (other.begin ())
-    { }
+    {
+      m_sizes[Index] = other.size ();
+    }
 
     template <std::size_t M, typename ...Subranges>
     partition_subrange (partition_subrange<list_partition<T, M, Container>, M>&& other,
@@ -652,9 +798,10 @@ namespace gch
                                  std::forward<Subranges> (subranges)...)
     { }
 
-    constexpr explicit
+    explicit
     partition_subrange (const alloc_ty& alloc)
-      : next_type (alloc)
+      : next_type (alloc),
+        m_first (m_container.end ())
     { }
 
   public:
@@ -717,7 +864,7 @@ namespace gch
     size_ty
     size (void) const noexcept
     {
-      return static_cast<size_ty> (std::distance (cbegin (), cend ()));
+      return m_sizes[Index];
     }
 
     GCH_NODISCARD
@@ -731,6 +878,7 @@ namespace gch
     clear (void) noexcept
     {
       set_first (m_container.erase (cbegin (), cend ()));
+      m_sizes[Index] = 0;
     }
 
     iter
@@ -738,6 +886,7 @@ namespace gch
     {
       iter ret = m_container.insert (pos, lv);
       propagate_first_left (pos, ret);
+      ++m_sizes[Index];
       return ret;
     }
 
@@ -746,6 +895,7 @@ namespace gch
     {
       iter ret = m_container.insert (pos, std::move (rv));
       propagate_first_left (pos, ret);
+      ++m_sizes[Index];
       return ret;
     }
 
@@ -754,6 +904,7 @@ namespace gch
     {
       iter ret = m_container.insert (pos, count, val);
       propagate_first_left (pos, ret);
+      m_sizes[Index] += count;
       return ret;
     }
 
@@ -763,6 +914,7 @@ namespace gch
     {
       iter ret = m_container.insert (pos, first, last);
       propagate_first_left (pos, ret);
+      m_sizes[Index] += static_cast<size_ty> (std::distance (citer (ret), pos));
       return ret;
     }
 
@@ -771,6 +923,7 @@ namespace gch
     {
       iter ret = m_container.insert (pos, ilist);
       propagate_first_left (pos, ret);
+      m_sizes[Index] += ilist.size ();
       return ret;
     }
 
@@ -780,6 +933,7 @@ namespace gch
     {
       iter ret = m_container.emplace (pos, std::forward<Args> (args)...);
       propagate_first_left (pos, ret);
+      ++m_sizes[Index];
       return ret;
     }
 
@@ -788,12 +942,14 @@ namespace gch
     {
       iter ret = m_container.erase (pos);
       propagate_first_left (pos, ret);
+      --m_sizes[Index];
       return ret;
     }
 
     iter
     erase (const citer first, const citer last)
     {
+      m_sizes[Index] -= static_cast<size_ty> (std::distance (first, last));
       iter ret = m_container.erase (first, last);
       propagate_first_left (first, ret);
       return ret;
@@ -828,12 +984,14 @@ namespace gch
     push_front (const value_ty& val)
     {
       set_first (m_container.insert (cbegin (), val));
+      ++m_sizes[Index];
     }
 
     void
     push_front (value_ty&& val)
     {
       set_first (m_container.insert (cbegin (), std::move (val)));
+      ++m_sizes[Index];
     }
 
     template <typename ...Args>
@@ -841,6 +999,7 @@ namespace gch
     emplace_front (Args&&... args)
     {
       set_first (m_container.emplace (cbegin (), std::forward<Args> (args)...));
+      ++m_sizes[Index];
       return *begin ();
     }
 
@@ -848,6 +1007,7 @@ namespace gch
     pop_front (void)
     {
       set_first (m_container.erase (cbegin ()));
+      --m_sizes[Index];
     }
 
     void
@@ -883,35 +1043,21 @@ namespace gch
         erase (pos.first, cend ());
     }
 
-    template <std::size_t M, std::size_t J>
+    template <std::size_t M, std::size_t J, typename std::enable_if<(M != N)>::type * = nullptr>
     void
     swap (partition_subrange<list_partition<T, M, Container>, J>& other)
     {
-      if (&other == this)
-        return;
-
-      iter tmp_first = begin ();
-
-      other.m_container.splice (other.cend (), std::move (m_container), cbegin (), cend ());
-      m_container.splice (cend (), std::move (other.m_container), other.cbegin (), tmp_first);
-
-      set_first (other.m_first);
-      other.set_first (tmp_first);
+      swap_between (other);
     }
 
-    template <std::size_t M>
+    template <std::size_t J>
     void
-    swap (partition_subrange<list_partition<T, M, Container>, 0>& other)
+    swap (partition_subrange<partition_type, J>& other)
     {
-      if (&other == this)
-        return;
-
-      iter other_first = other.begin ();
-
-      other.m_container.splice (other.cend (), std::move (m_container), cbegin (), cend ());
-      m_container.splice (cend (), std::move (other.m_container), other.cbegin (), m_first);
-
-      set_first (other_first);
+      if (&other.m_container == &m_container)
+        swap_in_place (other);
+      else
+        swap_between (other);
     }
 
     template <std::size_t M, std::size_t J, typename ...Args>
@@ -934,10 +1080,13 @@ namespace gch
       tmp2.splice (tmp2.cend (), std::move (other.m_container), other.cbegin (), other.cend ());
       tmp1.merge (std::move (tmp2), std::forward<Args> (args)...);
 
-      iter new_first = tmp1.begin ();
+      iter new_first = tmp1.empty () ? end () : tmp1.begin ();
       m_container.splice (cend (), tmp1);
       set_first (new_first);
       other.set_first (other.end ());
+
+      m_sizes[Index] += other.size ();
+      other.m_sizes[J] = 0;
     }
 
     template <std::size_t M, std::size_t J, typename ...Args>
@@ -952,10 +1101,18 @@ namespace gch
     void
     splice (const citer pos, partition_subrange<list_partition<T, M, Container>, J>&& other)
     {
+      if (other.empty ())
+        return;
+
       iter first = other.begin ();
-      m_container.splice (pos, std::move (other.m_container), first, other.cend ());
-      other.set_first (other.end ());
-      propagate_first_left (pos, first);
+      // if `other` directly follows this subrange its elements are already in place, but moving
+      // its front also moves ours if we are empty
+      iter last = other.end ();
+      if (pos != first)
+        m_container.splice (pos, std::move (other.m_container), first, last);
+      other.set_first (last);
+      propagate_first_left ((pos != first) ? pos : citer (last), first);
+      transfer_size (other, other.size ());
     }
 
     template <std::size_t M, std::size_t J>
@@ -966,7 +1123,8 @@ namespace gch
       citer new_other_front = std::next (cit);
       m_container.splice (pos, std::move (other.m_container), cit);
       other.propagate_first_left (cit, get_iter (new_other_front));
-      propagate_first_left (pos, get_iter (cit));
+      propagate_first_left ((pos != cit) ? pos : new_other_front, get_iter (cit));
+      transfer_size (other, 1);
     }
 
     template <std::size_t M, std::size_t J>
@@ -974,9 +1132,16 @@ namespace gch
     splice (const citer pos, partition_subrange<list_partition<T, M, Container>, J>&& other,
             const citer first, const citer last)
     {
-      m_container.splice (pos, std::move (other.m_container), first, last);
+      if (first == last)
+        return;
+
+      const size_ty count = static_cast<size_ty> (std::distance (first, last));
+      // see above
+      if (pos != first)
+        m_container.splice (pos, std::move (other.m_container), first, last);
       other.propagate_first_left (first, get_iter (last));
-      propagate_first_left (pos, get_iter (first));
+      propagate_first_left ((pos != first) ? pos : last, get_iter (first));
+      transfer_size (other, count);
     }
 
     size_ty
@@ -992,11 +1157,11 @@ namespace gch
       container_type tmp;
       tmp.splice (tmp.end (), std::move (m_container), cbegin (), cend ());
 
-      size_ty original_size = tmp.size ();
       tmp.remove_if (p);
-      size_ty num_removed = original_size - tmp.size ();
+      size_ty num_removed = m_sizes[Index] - tmp.size ();
+      m_sizes[Index] = tmp.size ();
 
-      iter new_first = tmp.begin ();
+      iter new_first = tmp.empty () ? end () : tmp.begin ();
       m_container.splice (cend (), tmp);
       set_first (new_first);
 
@@ -1010,7 +1175,8 @@ namespace gch
       container_type tmp;
       tmp.splice (tmp.end (), std::move (m_container), cbegin (), cend ());
       tmp.unique (std::forward<Args> (args)...);
-      iter new_first = tmp.begin ();
+      m_sizes[Index] = tmp.size ();
+      iter new_first = tmp.empty () ? end () : tmp.begin ();
       m_container.splice (cend (), tmp);
       set_first (new_first);
     }
@@ -1022,11 +1188,25 @@ namespace gch
       container_type tmp;
       tmp.splice (tmp.end (), std::move (m_container), cbegin (), cend ());
       tmp.sort (std::forward<Args> (args)...);
-      iter new_first = tmp.begin ();
+      iter new_first = tmp.empty () ? end () : tmp.begin ();
       m_container.splice (cend (), tmp);
       set_first (new_first);
     }
 
+    // See `partition_subrange<list_partition, 0>::defragment`.
+    void
+    defragment (void)
+    {
+      if (empty ())
+        return;
+
+      // the empty subranges in front of us share our first iterator, so they have to be moved
+      // off the old nodes before those are erased
+      const iter old_first = begin ();
+      set_first (relocate_nodes (old_first, end ()));
+      m_container.erase (old_first, cbegin ());
+    }
+
     subrange_view<iter>
     view (void)
     {
@@ -1042,38 +1222,32 @@ namespace gch
     iter
     advance_begin (diff_ty change)
     {
-      if (change > 0)
+      if (change > 0 ? this->count_between (Index, N) < static_cast<size_ty> (change)
+                     : this->count_between (0, Index) < static_cast<size_ty> (-change))
       {
-        iter res = m_first;
-        for (diff_ty i = 0; i < change; ++i, static_cast<void> (++res))
-        {
-          if (res == m_container.end ())
-            throw std::out_of_range ("The requested change of subrange offset is out of range.");
-        }
+        throw std::out_of_range ("The requested change of subrange offset is out of range.");
+      }
+      return advance_begin_unchecked (change);
+    }
 
-        // rest should be noexcept
-        while (m_first != res)
-        {
-          next_subrange (*this).propagate_first_right (m_first, std::next (m_first));
-          std::advance (m_first, 1);
-        }
+    // Like `advance_begin`, but `change` must be known to be in range. Walks `change` elements
+    // and then sets every boundary it passed, using the cached sizes to find them.
+    iter
+    advance_begin_unchecked (diff_ty change) noexcept
+    {
+      iter res = std::next (m_first, change);
+      if (change > 0)
+      {
+        next_subrange (*this).carry_first_right (m_sizes[Index], static_cast<size_ty> (change),
+                                                 res);
       }
-      else
+      else if (change < 0)
       {
-        iter res = m_first;
-        for (diff_ty i = 0; i > change; --i, static_cast<void> (--res))
-        {
-          if (res == m_container.begin ())
-            throw std::out_of_range ("The requested change of subrange offset is out of range.");
-        }
-
-        // rest should be noexcept
-        while (m_first != res)
-        {
-          prev_subrange (*this).propagate_first_left (m_first, std::prev (m_first));
-          std::advance (m_first, -1);
-        }
+        prev_subrange (*this).carry_first_left (m_sizes[Index - 1],
+                                                static_cast<size_ty> (-change), res);
       }
+      m_first = res;
+      this->shift_sizes (Index, change);
       return m_first;
     }
 
@@ -1088,15 +1262,35 @@ namespace gch
     iter
     advance_end (diff_ty change) = delete;
 
+    template <std::size_t J = Index, typename std::enable_if<(J < N - 1)>::type * = nullptr>
+    iter
+    advance_end_unchecked (diff_ty change) noexcept
+    {
+      return next_subrange (*this).advance_begin_unchecked (change);
+    }
+
+    template <std::size_t J = Index, typename std::enable_if<(J == N - 1)>::type * = nullptr>
+    iter
+    advance_end_unchecked (diff_ty change) = delete;
+
   protected:
     void
     partition_swap (partition_subrange& other)
       noexcept (next_type::template is_nothrow_swappable<size_ty>::value &&
                 noexcept (std::declval<next_type&> ().partition_swap (other)))
     {
+      // an end iterator stays with its list when the lists are swapped
+      const bool at_end       = m_first == m_container.end ();
+      const bool other_at_end = other.m_first == other.m_container.end ();
+
       using std::swap;
       swap (m_first, other.m_first);
       next_type::partition_swap (other);
+
+      if (other_at_end)
+        m_first = m_container.end ();
+      if (at_end)
+        other.m_first = other.m_container.end ();
     }
 
   private:
@@ -1106,6 +1300,92 @@ namespace gch
       return m_container.erase (cit, cit);
     }
 
+    template <std::size_t M, std::size_t J>
+    void
+    swap_between (partition_subrange<list_partition<T, M, Container>, J>& other)
+    {
+      iter tmp_first = begin ();
+
+      other.m_container.splice (other.cend (), std::move (m_container), cbegin (), cend ());
+      m_container.splice (cend (), std::move (other.m_container), other.cbegin (), tmp_first);
+
+      set_first (other.m_first);
+      other.set_first (tmp_first);
+      std::swap (m_sizes[Index], other.m_sizes[J]);
+    }
+
+    template <std::size_t M>
+    void
+    swap_between (partition_subrange<list_partition<T, M, Container>, 0>& other)
+    {
+      iter other_first = other.begin ();
+
+      other.m_container.splice (other.cend (), std::move (m_container), cbegin (), cend ());
+      m_container.splice (cend (), std::move (other.m_container), other.cbegin (), m_first);
+
+      set_first (other_first);
+      std::swap (m_sizes[Index], other.m_sizes[0]);
+    }
+
+    // Both subranges are in the same list, so just relink the nodes and fix up the first
+    // iterators of the subranges from here through J.
+    template <std::size_t J, typename std::enable_if<(Index < J)>::type * = nullptr>
+    void
+    swap_in_place (partition_subrange<partition_type, J>& other)
+    {
+      const iter a_first = begin ();
+      const iter a_last  = end ();
+      const iter b_first = other.begin ();
+      const iter b_last  = other.end ();
+
+      // move b in front of a, then a behind whatever was between them (if anything)
+      if (a_first != b_first)
+        m_container.splice (a_first, m_container, b_first, b_last);
+      if (a_last != b_first)
+        m_container.splice (b_last, m_container, a_first, a_last);
+
+      next_subrange (*this).template replace_first_through<J> (b_first,
+                                                               a_first == a_last ? b_last : a_first);
+      set_first (b_first != b_last ? b_first : next_subrange (*this).begin ());
+      std::swap (m_sizes[Index], m_sizes[J]);
+    }
+
+    template <std::size_t J, typename std::enable_if<(J < Index)>::type * = nullptr>
+    void
+    swap_in_place (partition_subrange<partition_type, J>& other)
+    {
+      other.swap_in_place (*this);
+    }
+
+    template <std::size_t J, typename std::enable_if<(J == Index)>::type * = nullptr>
+    void
+    swap_in_place (partition_subrange<partition_type, J>&) noexcept { }
+
+    template <std::size_t J, typename std::enable_if<(J == Index)>::type * = nullptr>
+    void
+    replace_first_through (citer cmp, iter replace) noexcept
+    {
+      if (m_first == cmp)
+        m_first = replace;
+    }
+
+    template <std::size_t J, typename std::enable_if<(Index < J)>::type * = nullptr>
+    void
+    replace_first_through (citer cmp, iter replace) noexcept
+    {
+      replace_first_through<Index> (cmp, replace);
+      next_subrange (*this).template replace_first_through<J> (cmp, replace);
+    }
+
+    template <std::size_t M, std::size_t J>
+    void
+    transfer_size (partition_subrange<list_partition<T, M, Container>, J>& other,
+                   size_ty count) noexcept
+    {
+      other.m_sizes[J] -= count;
+      m_sizes[Index]   += count;
+    }
+
     void
     set_first (iter replace)
     {
@@ -1133,6 +1413,37 @@ namespace gch
       }
     }
 
+    // `dist` is the number of elements between the boundary being moved and our front. If the
+    // boundary moves `change` elements past our front, our front moves with it.
+    void
+    carry_first_right (size_ty dist, size_ty change, iter replace) noexcept
+    {
+      if (dist < change)
+      {
+        next_subrange (*this).carry_first_right (dist + m_sizes[Index], change, replace);
+        m_first = replace;
+      }
+    }
+
+    void
+    carry_first_left (size_ty dist, size_ty change, iter replace) noexcept
+    {
+      if (dist < change)
+      {
+        prev_subrange (*this).carry_first_left (dist + m_sizes[Index - 1], change, replace);
+        m_first = replace;
+      }
+    }
+
+    void
+    assign_first (iter pos, const std::array<size_ty, N>& sizes)
+    {
+      m_first = pos;
+      if (Index + 1 < N)
+        std::advance (pos, static_cast<diff_ty> (sizes[Index]));
+      next_type::assign_first (pos, sizes);
+    }
+
     std::pair<citer, size_ty>
     resize_pos (const size_ty count) const
     {
@@ -1191,6 +1502,7 @@ namespace gch
 
   protected:
     using base::m_container;
+    using base::m_sizes;
 
     partition_subrange            (void)                          = default;
     partition_subrange            (const partition_subrange&)     = default;
@@ -1258,6 +1570,9 @@ namespace gch
     iter                 advance_begin (diff_ty)     = delete;
     iter                 advance_end   (diff_ty)     = delete;
 
+    iter advance_begin_unchecked (diff_ty) = delete;
+    iter advance_end_unchecked   (diff_ty) = delete;
+
   protected:
     template <typename U>
     struct is_nothrow_swappable
@@ -1277,12 +1592,15 @@ namespace gch
     partition_swap (partition_subrange& other)
       noexcept (is_nothrow_swappable<container_type>::value)
     {
-      using std::swap;
-      swap (m_container, other.m_container);
+      base::partition_swap (other);
     }
 
   private:
-    static void propagate_first_right (citer, iter) noexcept { }
+    static void propagate_first_right (citer, iter)          noexcept { }
+    static void carry_first_right     (size_ty, size_ty, iter) noexcept { }
+
+    template <typename Sizes>
+    static void assign_first (iter, const Sizes&) noexcept { }
   };
 
   // holds the container
@@ -1425,10 +1743,100 @@ namespace gch
     {
       using std::swap;
       swap (m_container, other.m_container);
+      swap (m_sizes, other.m_sizes);
+    }
+
+    GCH_NODISCARD
+    size_ty
+    count_between (std::size_t first, std::size_t last) const noexcept
+    {
+      size_ty count = 0;
+      for (std::size_t i = first; i < last; ++i)
+        count += m_sizes[i];
+      return count;
+    }
+
+    // Updates the sizes after `change` elements crossed the front boundary of subrange `idx`
+    // (to the left if positive). Empty subranges at the boundary are carried along, so the
+    // elements come out of the nearest subranges that have any.
+    void
+    shift_sizes (std::size_t idx, diff_ty change) noexcept
+    {
+      if (change > 0)
+      {
+        size_ty count = static_cast<size_ty> (change);
+        m_sizes[idx - 1] += count;
+        for (std::size_t i = idx; count != 0; ++i)
+        {
+          const size_ty taken = (std::min) (count, m_sizes[i]);
+          m_sizes[i] -= taken;
+          count      -= taken;
+        }
+      }
+      else
+      {
+        size_ty count = static_cast<size_ty> (-change);
+        m_sizes[idx] += count;
+        for (std::size_t i = idx; count != 0; --i)
+        {
+          const size_ty taken = (std::min) (count, m_sizes[i - 1]);
+          m_sizes[i - 1] -= taken;
+          count          -= taken;
+        }
+      }
+    }
+
+    // Rebuilds [first, last) in front of `last` in new nodes, allocated one after another, and
+    // returns the first of them. The old nodes are left for the caller to erase. Elements are
+    // moved if moving them back cannot throw, and they are moved back if an allocation fails.
+    // Otherwise they are copied, so [first, last) is unchanged on failure unless the type is
+    // move-only with a throwing move constructor.
+    iter
+    relocate_nodes (iter first, iter last)
+    {
+      using restorable = std::integral_constant<bool,
+        std::is_nothrow_move_constructible<value_ty>::value
+        && std::is_nothrow_move_assignable<value_ty>::value>;
+
+      container_type tmp (m_container.get_allocator ());
+      relocate_into (tmp, first, last, restorable { });
+      if (tmp.empty ())
+        return last;
+
+      iter new_first = tmp.begin ();
+      m_container.splice (last, tmp);
+      return new_first;
+    }
+
+  private:
+    void
+    relocate_into (container_type& tmp, iter first, const iter last, std::true_type)
+    {
+      try
+      {
+        for (iter it = first; it != last; ++it)
+          tmp.push_back (std::move (*it));
+      }
+      catch (...)
+      {
+        for (ref elem : tmp)
+          *first++ = std::move (elem);
+        throw;
+      }
+    }
+
+    void
+    relocate_into (container_type& tmp, iter first, const iter last, std::false_type)
+    {
+      using source_ref = typename std::conditional<std::is_copy_constructible<value_ty>::value,
+                                                   const value_ty&, value_ty&&>::type;
+      for (; first != last; ++first)
+        tmp.push_back (static_cast<source_ref> (*first));
     }
 
   protected:
-    container_type m_container;
+    container_type         m_container;
+    std::array<size_ty, N> m_sizes { };
   };
 
   template <typename T, std::size_t N, typename C, std::size_t I>
@@ -1496,16 +1904,35 @@ namespace gch
 
   protected:
     using last_type::m_container;
+    using last_type::m_sizes;
+    using last_type::relocate_nodes;
 
   public:
 
     list_partition            (void)                      = default;
     list_partition            (const list_partition&)     = default;
     list_partition            (list_partition&&) noexcept = default;
-    list_partition& operator= (const list_partition&)     = default;
-    list_partition& operator= (list_partition&&) noexcept = default;
     ~list_partition           (void)                      = default;
 
+    // the subranges assign their own elements, so these are done in terms of swap
+    list_partition&
+    operator= (const list_partition& other)
+    {
+      if (&other != this)
+      {
+        list_partition tmp (other);
+        swap (tmp);
+      }
+      return *this;
+    }
+
+    list_partition&
+    operator= (list_partition&& other) noexcept
+    {
+      swap (other);
+      return *this;
+    }
+
     // concatenation constructor
     template <std::size_t M, typename ...Partitions>
     constexpr
@@ -1651,6 +2078,113 @@ namespace gch
       return get_subrange<Index> (*this).advance_end (change);
     }
 
+    // These skip the range check; use them when `change` is already known to be valid (from the
+    // subrange sizes, for example).
+    template <std::size_t Index,
+              typename = typename std::enable_if<(0 < Index) && (Index < N)>::type>
+    data_iter
+    advance_begin_unchecked (data_diff_t change) noexcept
+    {
+      return get_subrange<Index> (*this).advance_begin_unchecked (change);
+    }
+
+    template <std::size_t Index,
+              typename = typename std::enable_if<(Index < N)>::type>
+    data_iter
+    advance_end_unchecked (data_diff_t change) noexcept
+    {
+      return get_subrange<Index> (*this).advance_end_unchecked (change);
+    }
+
+    // Resizes every subrange at once without moving any elements. The sizes must add up to
+    // `data_size ()`.
+    void
+    set_boundaries (const std::array<data_size_t, N>& sizes)
+    {
+      data_size_t total = 0;
+      for (const data_size_t n : sizes)
+        total += n;
+
+      if (total != data_size ())
+        throw std::invalid_argument ("subrange sizes do not add up to the data size");
+
+      first_type::assign_firsts (sizes);
+      m_sizes = sizes;
+    }
+
+    template <typename Iterator>
+    void
+    set_boundaries (Iterator first, Iterator last)
+    {
+      std::array<data_size_t, N> sizes;
+      auto it = sizes.begin ();
+      for (; first != last; ++first, ++it)
+      {
+        if (it == sizes.end ())
+          throw std::invalid_argument ("expected exactly one size per subrange");
+        *it = static_cast<data_size_t> (*first);
+      }
+
+      if (it != sizes.end ())
+        throw std::invalid_argument ("expected exactly one size per subrange");
+
+      set_boundaries (sizes);
+    }
+
+  private:
+    friend struct detail::list_partition_access;
+
+    // Moves every subrange out into its own container. Only nodes are relinked, so no elements
+    // are copied. The partition is left empty until `splice_subranges` puts them back.
+    std::vector<container_type>
+    extract_subranges (void)
+    {
+      std::vector<container_type> ret;
+      ret.reserve (N);
+      for (std::size_t i = 0; i < N; ++i)
+        ret.emplace_back (m_container.get_allocator ());
+
+      partition_view<list_partition, N> views (*this);
+      for (std::size_t i = 0; i < N; ++i)
+        ret[i].splice (ret[i].end (), m_container, views[i].begin (), views[i].end ());
+
+      set_boundaries (std::array<data_size_t, N> { });
+      return ret;
+    }
+
+    // Appends each container to the back of the corresponding subrange by relinking its nodes.
+    // The containers must use an allocator equal to ours.
+    void
+    splice_subranges (std::vector<container_type>&& lists)
+    {
+      std::array<data_size_t, N> sizes;
+      container_type tmp (m_container.get_allocator ());
+      partition_view<list_partition, N> views (*this);
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        sizes[i] = m_sizes[i] + lists[i].size ();
+        tmp.splice (tmp.end (), m_container, views[i].begin (), views[i].end ());
+        tmp.splice (tmp.end (), lists[i]);
+      }
+
+      m_container.splice (m_container.end (), tmp);
+      set_boundaries (sizes);
+    }
+
+  public:
+    // Moves every element into a new node, allocated one after another in traversal order, and
+    // rebuilds the subrange boundaries from the cached sizes. After heavy splicing and erasing
+    // this puts the nodes back in memory order, so a traversal no longer jumps around the heap.
+    // Gives the same guarantee as the subrange version if an allocation throws. Iterators and
+    // references to the elements are invalidated.
+    void
+    defragment (void)
+    {
+      m_container.erase (m_container.cbegin (),
+                         relocate_nodes (m_container.begin (), m_container.end ()));
+      first_type::assign_firsts (m_sizes);
+    }
+
     void
     swap (list_partition& other)
       noexcept (noexcept (std::declval<list_partition&> ().partition_swap (other)))
@@ -1715,6 +2249,9 @@ namespace gch
   {
     using citer = typename partition_subrange<list_partition<T, N, C>, I>::const_iterator;
 
+    if (lhs.size () != rhs.size ())
+      return false;
+
     citer it_lhs  = lhs.begin ();
     citer it_rhs  = rhs.begin ();
 
@@ -0,0 +1,1221 @@
+/** parallel.hpp
+ * Short description here.
+ *
+ * Copyright © 2020 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef PARTITION_PARALLEL_HPP
+#define PARTITION_PARALLEL_HPP
+
+#include "list_partition.hpp"
+#include "vector_partition.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace gch
+{
+
+  namespace detail
+  {
+
+    // Raw storage for `count` objects of type `T`. Constructing and destroying the objects is
+    // left to the user.
+    template <typename T>
+    class uninitialized_buffer
+    {
+    public:
+      uninitialized_buffer            (const uninitialized_buffer&) = delete;
+      uninitialized_buffer            (uninitialized_buffer&&)      = delete;
+      uninitialized_buffer& operator= (const uninitialized_buffer&) = delete;
+      uninitialized_buffer& operator= (uninitialized_buffer&&)      = delete;
+
+      explicit uninitialized_buffer (std::size_t count)
+        : m_data  (std::allocator<T> ().allocate (count)),
+          m_count (count)
+      { }
+
+      ~uninitialized_buffer (void)
+      {
+        std::allocator<T> ().deallocate (m_data, m_count);
+      }
+
+      GCH_NODISCARD
+      T *
+      data (void) const noexcept
+      {
+        return m_data;
+      }
+
+    private:
+      T           *m_data;
+      std::size_t  m_count;
+    };
+
+    inline
+    std::size_t
+    default_thread_count (void) noexcept
+    {
+      return std::max (std::thread::hardware_concurrency (), 1U);
+    }
+
+    // shared by every thread taking part in one `thread_pool::parallel_for`
+    class loop_state
+    {
+    public:
+      explicit loop_state (std::size_t count) noexcept
+        : m_count (count)
+      { }
+
+      // claims and runs iterations until there are none left
+      template <typename F>
+      void
+      run (F& f)
+      {
+        for (std::size_t i = m_next++; i < m_count; i = m_next++)
+        {
+          try
+          {
+            f (i);
+          }
+          catch (...)
+          {
+            std::lock_guard<std::mutex> lock (m_mutex);
+            if (! m_error)
+              m_error = std::current_exception ();
+          }
+
+          if (++m_done == m_count)
+          {
+            std::lock_guard<std::mutex> lock (m_mutex);
+            m_finished.notify_all ();
+          }
+        }
+      }
+
+      // waits for every iteration to finish and rethrows the first exception
+      void
+      wait (void)
+      {
+        std::unique_lock<std::mutex> lock (m_mutex);
+        m_finished.wait (lock, [this] { return m_done == m_count; });
+        if (m_error)
+          std::rethrow_exception (m_error);
+      }
+
+    private:
+      const std::size_t        m_count;
+      std::atomic<std::size_t> m_next { 0 };
+      std::atomic<std::size_t> m_done { 0 };
+      std::mutex               m_mutex;
+      std::condition_variable  m_finished;
+      std::exception_ptr       m_error;
+    };
+
+    // identifies the scheduler worker running on the current thread, if any
+    struct worker_identity
+    {
+      const void  *scheduler;
+      std::size_t  index;
+    };
+
+    inline
+    worker_identity&
+    this_worker (void) noexcept
+    {
+      static thread_local worker_identity id { nullptr, 0 };
+      return id;
+    }
+
+  } // namespace detail
+
+  // A fixed set of worker threads. The thread calling `parallel_for` works alongside them, so a
+  // pool of size 1 has no workers and runs everything on the caller.
+  class thread_pool
+  {
+  public:
+    thread_pool            (const thread_pool&) = delete;
+    thread_pool            (thread_pool&&)      = delete;
+    thread_pool& operator= (const thread_pool&) = delete;
+    thread_pool& operator= (thread_pool&&)      = delete;
+
+    thread_pool (void)
+      : thread_pool (detail::default_thread_count ())
+    { }
+
+    explicit thread_pool (std::size_t thread_count)
+    {
+      try
+      {
+        for (std::size_t i = 1; i < thread_count; ++i)
+          m_workers.emplace_back ([this] { work (); });
+      }
+      catch (...)
+      {
+        stop ();
+        throw;
+      }
+    }
+
+    ~thread_pool (void)
+    {
+      stop ();
+    }
+
+    GCH_NODISCARD
+    std::size_t
+    size (void) const noexcept
+    {
+      return m_workers.size () + 1;
+    }
+
+    // Runs `f (i)` for every `i` in [0, count) and waits for all of them. Iterations are claimed
+    // dynamically, so uneven iterations balance themselves. The first exception thrown is
+    // rethrown here. Calling this from inside a task is fine since the caller never idles.
+    template <typename F>
+    void
+    parallel_for (std::size_t count, F&& f)
+    {
+      if (count == 0)
+        return;
+
+      std::shared_ptr<detail::loop_state> state = std::make_shared<detail::loop_state> (count);
+      const std::size_t helpers = std::min (count - 1, m_workers.size ());
+      if (helpers != 0)
+      {
+        {
+          std::lock_guard<std::mutex> lock (m_mutex);
+          for (std::size_t i = 0; i < helpers; ++i)
+            m_tasks.emplace_back ([state, &f] { state->run (f); });
+        }
+        m_cv.notify_all ();
+      }
+
+      state->run (f);
+      state->wait ();
+    }
+
+    // the pool used by the algorithms when none is given
+    static
+    thread_pool&
+    default_pool (void)
+    {
+      static thread_pool pool;
+      return pool;
+    }
+
+  private:
+    void
+    work (void)
+    {
+      for (;;)
+      {
+        std::function<void ()> task;
+        {
+          std::unique_lock<std::mutex> lock (m_mutex);
+          m_cv.wait (lock, [this] { return m_stopping || ! m_tasks.empty (); });
+          if (m_tasks.empty ())
+            return;
+
+          task = std::move (m_tasks.front ());
+          m_tasks.pop_front ();
+        }
+        task ();
+      }
+    }
+
+    void
+    stop (void) noexcept
+    {
+      {
+        std::lock_guard<std::mutex> lock (m_mutex);
+        m_stopping = true;
+      }
+      m_cv.notify_all ();
+
+      for (std::thread& t : m_workers)
+        t.join ();
+      m_workers.clear ();
+    }
+
+    std::vector<std::thread>           m_workers;
+    std::deque<std::function<void ()>> m_tasks;
+    std::mutex                         m_mutex;
+    std::condition_variable            m_cv;
+    bool                               m_stopping = false;
+  };
+
+  // Runs tasks on a fixed set of workers with one deque per worker. All queued tasks live in one
+  // contiguous buffer split into a region of equal capacity per worker, and the tasks of worker
+  // `i` are the subrange [front, back) of region `i`, so the buffer is a partition with slack
+  // after every subrange, laid out like a `gap_vector_partition`.
+  //
+  // Each subrange has a lock of its own on its boundaries. A worker pushes and pops at the back
+  // of its subrange, so it runs its own tasks newest first. An idle worker steals the oldest
+  // task of another subrange by advancing that subrange's front. Two threads only contend when
+  // they touch the same subrange. A task submitted from inside a task goes to the current
+  // worker's subrange, and other submissions are spread round robin. When a subrange fills its
+  // region, every region is doubled, which takes all the locks in index order and moves every
+  // queued task once. `Task` must be default constructible and move assignable.
+  template <typename Task = std::function<void ()>>
+  class work_stealing_scheduler
+  {
+  public:
+    using task_type = Task;
+
+    work_stealing_scheduler            (const work_stealing_scheduler&) = delete;
+    work_stealing_scheduler            (work_stealing_scheduler&&)      = delete;
+    work_stealing_scheduler& operator= (const work_stealing_scheduler&) = delete;
+    work_stealing_scheduler& operator= (work_stealing_scheduler&&)      = delete;
+
+    work_stealing_scheduler (void)
+      : work_stealing_scheduler (detail::default_thread_count ())
+    { }
+
+    explicit work_stealing_scheduler (std::size_t worker_count, std::size_t capacity = 64)
+      : m_bounds   (std::max (worker_count, std::size_t { 1 })),
+        m_capacity (std::max (capacity, std::size_t { 1 })),
+        m_buffer   (m_bounds.size () * m_capacity)
+    {
+      for (std::size_t i = 0; i < m_bounds.size (); ++i)
+      {
+        m_bounds[i].front = region_begin (i);
+        m_bounds[i].back  = region_begin (i);
+      }
+
+      try
+      {
+        for (std::size_t i = 0; i < m_bounds.size (); ++i)
+          m_workers.emplace_back ([this, i] { work (i); });
+      }
+      catch (...)
+      {
+        stop ();
+        throw;
+      }
+    }
+
+    // runs every queued task before returning
+    ~work_stealing_scheduler (void)
+    {
+      stop ();
+    }
+
+    GCH_NODISCARD
+    std::size_t
+    size (void) const noexcept
+    {
+      return m_bounds.size ();
+    }
+
+    void
+    submit (task_type task)
+    {
+      const detail::worker_identity& id = detail::this_worker ();
+      const std::size_t i = (id.scheduler == this) ? id.index : m_next_queue++ % size ();
+
+      ++m_pending;
+      ++m_queued;
+      try
+      {
+        push (i, task);
+      }
+      catch (...)
+      {
+        --m_queued;
+        finish_one ();
+        throw;
+      }
+
+      if (m_sleepers.load () != 0)
+      {
+        std::lock_guard<std::mutex> lock (m_sleep_mutex);
+        m_wake.notify_one ();
+      }
+    }
+
+    // waits until every submitted task has finished, then rethrows the first exception thrown by
+    // a task. must not be called from inside a task.
+    void
+    wait (void)
+    {
+      std::unique_lock<std::mutex> lock (m_idle_mutex);
+      m_idle.wait (lock, [this] { return m_pending.load () == 0; });
+      if (m_error)
+      {
+        std::exception_ptr e = m_error;
+        m_error = nullptr;
+        std::rethrow_exception (e);
+      }
+    }
+
+  private:
+    // the boundaries of one subrange. aligned so that workers locking neighbouring subranges do
+    // not share a cache line.
+    struct alignas (64) bounds
+    {
+      std::mutex  mutex;
+      std::size_t front = 0;
+      std::size_t back  = 0;
+    };
+
+    // callers hold at least one lock, which keeps `m_capacity` stable
+    std::size_t
+    region_begin (std::size_t i) const noexcept
+    {
+      return i * m_capacity;
+    }
+
+    void
+    push (std::size_t i, task_type& task)
+    {
+      for (;;)
+      {
+        {
+          std::lock_guard<std::mutex> lock (m_bounds[i].mutex);
+          bounds& b = m_bounds[i];
+          const std::size_t end = region_begin (i) + m_capacity;
+          if (b.back == end && b.front != region_begin (i))
+          {
+            // slide the subrange back to the start of its region
+            task_type *data = m_buffer.data ();
+            std::move (data + b.front, data + b.back, data + region_begin (i));
+            b.back -= b.front - region_begin (i);
+            b.front = region_begin (i);
+            std::fill (data + b.back, data + end, task_type ());
+          }
+
+          if (b.back != end)
+          {
+            m_buffer[b.back++] = std::move (task);
+            return;
+          }
+        }
+        grow (i);
+      }
+    }
+
+    // doubles every region if subrange `i` still fills its own
+    void
+    grow (std::size_t i)
+    {
+      std::vector<std::unique_lock<std::mutex>> locks;
+      locks.reserve (size ());
+      for (std::size_t j = 0; j < size (); ++j)
+        locks.emplace_back (m_bounds[j].mutex);
+
+      if (m_bounds[i].back - m_bounds[i].front != m_capacity)
+        return;
+
+      const std::size_t capacity = 2 * m_capacity;
+      std::vector<task_type> buffer (size () * capacity);
+      task_type *src = m_buffer.data ();
+      task_type *dst = buffer.data ();
+      for (std::size_t j = 0; j < size (); ++j)
+      {
+        bounds& b = m_bounds[j];
+        std::move (src + b.front, src + b.back, dst + j * capacity);
+        b.back  = j * capacity + (b.back - b.front);
+        b.front = j * capacity;
+      }
+      m_buffer.swap (buffer);
+      m_capacity = capacity;
+    }
+
+    // pops the newest task of subrange `i`
+    bool
+    pop_back (std::size_t i, task_type& task)
+    {
+      std::lock_guard<std::mutex> lock (m_bounds[i].mutex);
+      bounds& b = m_bounds[i];
+      if (b.front == b.back)
+        return false;
+
+      task = std::move (m_buffer[--b.back]);
+      m_buffer[b.back] = task_type ();
+      if (b.front == b.back)
+        b.front = b.back = region_begin (i);
+      return true;
+    }
+
+    // steals the oldest task of subrange `i`
+    bool
+    pop_front (std::size_t i, task_type& task)
+    {
+      std::lock_guard<std::mutex> lock (m_bounds[i].mutex);
+      bounds& b = m_bounds[i];
+      if (b.front == b.back)
+        return false;
+
+      task = std::move (m_buffer[b.front]);
+      m_buffer[b.front++] = task_type ();
+      if (b.front == b.back)
+        b.front = b.back = region_begin (i);
+      return true;
+    }
+
+    bool
+    take (std::size_t i, task_type& task)
+    {
+      if (pop_back (i, task))
+        return true;
+
+      for (std::size_t k = 1; k < size (); ++k)
+      {
+        if (pop_front ((i + k) % size (), task))
+          return true;
+      }
+      return false;
+    }
+
+    void
+    work (std::size_t i)
+    {
+      detail::this_worker () = { this, i };
+
+      task_type task;
+      for (;;)
+      {
+        if (take (i, task))
+        {
+          --m_queued;
+          try
+          {
+            task ();
+          }
+          catch (...)
+          {
+            std::lock_guard<std::mutex> lock (m_idle_mutex);
+            if (! m_error)
+              m_error = std::current_exception ();
+          }
+          task = task_type ();
+          finish_one ();
+          continue;
+        }
+
+        std::unique_lock<std::mutex> lock (m_sleep_mutex);
+        if (m_stopping && m_queued.load () == 0)
+          return;
+
+        ++m_sleepers;
+        m_wake.wait (lock, [this] { return m_stopping || m_queued.load () != 0; });
+        --m_sleepers;
+      }
+    }
+
+    void
+    finish_one (void)
+    {
+      if (--m_pending == 0)
+      {
+        std::lock_guard<std::mutex> lock (m_idle_mutex);
+        m_idle.notify_all ();
+      }
+    }
+
+    void
+    stop (void)
+    {
+      {
+        std::lock_guard<std::mutex> lock (m_sleep_mutex);
+        m_stopping = true;
+      }
+      m_wake.notify_all ();
+      for (std::thread& t : m_workers)
+        t.join ();
+      m_workers.clear ();
+    }
+
+    detail::aligned_array<bounds> m_bounds;
+    std::size_t                   m_capacity;
+    std::vector<task_type>        m_buffer;
+    std::vector<std::thread>      m_workers;
+    std::atomic<std::size_t>      m_pending    { 0 };
+    std::atomic<std::size_t>      m_queued     { 0 };
+    std::atomic<std::size_t>      m_sleepers   { 0 };
+    std::atomic<std::size_t>      m_next_queue { 0 };
+    std::mutex                    m_sleep_mutex;
+    std::condition_variable       m_wake;
+    std::mutex                    m_idle_mutex;
+    std::condition_variable       m_idle;
+    std::exception_ptr            m_error;
+    bool                          m_stopping = false;
+  };
+
+  // Lets many threads fill a `vector_partition` without locking. Constructing it reserves
+  // `counts[i]` slots at the back of every subrange `i` (see `vector_partition::reserve_layout`).
+  // Threads then write through `writer (i)`, which claims slots with an atomic cursor. `commit`
+  // checks that every slot was written. The partition must not be touched in any other way
+  // until then.
+  template <typename T, std::size_t N, typename Container = std::vector<T>>
+  class concurrent_fill
+  {
+  public:
+    using partition_type = vector_partition<T, N, Container>;
+    using data_iter      = typename partition_type::data_iter;
+    using size_type      = typename partition_type::data_size_t;
+
+  private:
+    // each cursor gets its own cache line so that producers of different subranges don't contend
+    struct alignas (64) cursor
+    {
+      std::atomic<size_type> next;
+      std::atomic<size_type> written;
+      size_type              last;
+    };
+
+  public:
+    class concurrent_writer
+    {
+    public:
+      concurrent_writer (concurrent_fill& fill, std::size_t index) noexcept
+        : m_fill  (&fill),
+          m_index (index)
+      { }
+
+      void
+      push (const T& val)
+      {
+        emplace (val);
+      }
+
+      void
+      push (T&& val)
+      {
+        emplace (std::move (val));
+      }
+
+      // assigns `T (args...)` to the next free slot of the subrange
+      template <typename ...Args>
+      void
+      emplace (Args&&... args)
+      {
+        cursor& c = m_fill->m_cursors[m_index];
+        const size_type slot = c.next.fetch_add (1, std::memory_order_relaxed);
+        if (slot >= c.last)
+          throw std::out_of_range ("no reserved slots are left in the subrange");
+
+        *std::next (m_fill->m_data, static_cast<std::ptrdiff_t> (slot))
+          = T (std::forward<Args> (args)...);
+        c.written.fetch_add (1, std::memory_order_release);
+      }
+
+    private:
+      concurrent_fill *m_fill;
+      std::size_t      m_index;
+    };
+
+    concurrent_fill            (const concurrent_fill&) = delete;
+    concurrent_fill            (concurrent_fill&&)      = delete;
+    concurrent_fill& operator= (const concurrent_fill&) = delete;
+    concurrent_fill& operator= (concurrent_fill&&)      = delete;
+    ~concurrent_fill           (void)                   = default;
+
+    concurrent_fill (partition_type& p, const std::array<size_type, N>& counts)
+    {
+      p.reserve_layout (counts);
+      m_data = p.data_begin ();
+
+      partition_view<partition_type, N> views (p);
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        const size_type last = static_cast<size_type> (std::distance (m_data, views[i].end ()));
+        m_cursors[i].next.store (last - counts[i], std::memory_order_relaxed);
+        m_cursors[i].written.store (0, std::memory_order_relaxed);
+        m_cursors[i].last = last;
+        m_reserved[i]     = counts[i];
+      }
+    }
+
+    GCH_NODISCARD
+    concurrent_writer
+    writer (std::size_t i) noexcept
+    {
+      return { *this, i };
+    }
+
+    // Throws `std::logic_error` if any reserved slot was not written. Must be called after all
+    // writers are done.
+    void
+    commit (void) const
+    {
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        if (m_cursors[i].written.load (std::memory_order_acquire) != m_reserved[i])
+          throw std::logic_error ("not every reserved slot was written");
+      }
+    }
+
+  private:
+    std::array<cursor, N>    m_cursors;
+    std::array<size_type, N> m_reserved;
+    data_iter                m_data;
+  };
+
+  template <typename Partition>
+  class partition_collector;
+
+  // Collects elements produced by many threads into a `vector_partition`. Every thread stages its
+  // elements in its own N vectors, so producing takes no locks and shifts nothing. `collect`
+  // then merges all of them into the partition with one prefix sum, one allocation and a
+  // parallel scatter.
+  template <typename T, std::size_t N, typename Container>
+  class partition_collector<vector_partition<T, N, Container>>
+  {
+  public:
+    using partition_type = vector_partition<T, N, Container>;
+    using size_type      = typename partition_type::data_size_t;
+
+    // the staging vectors of one thread
+    class local_buffer
+    {
+    public:
+      void
+      push_back (std::size_t i, const T& val)
+      {
+        m_staged[i].push_back (val);
+      }
+
+      void
+      push_back (std::size_t i, T&& val)
+      {
+        m_staged[i].push_back (std::move (val));
+      }
+
+      template <typename ...Args>
+      T&
+      emplace_back (std::size_t i, Args&&... args)
+      {
+        m_staged[i].emplace_back (std::forward<Args> (args)...);
+        return m_staged[i].back ();
+      }
+
+    private:
+      friend class partition_collector;
+
+      std::array<std::vector<T>, N> m_staged;
+    };
+
+    partition_collector            (const partition_collector&) = delete;
+    partition_collector            (partition_collector&&)      = delete;
+    partition_collector& operator= (const partition_collector&) = delete;
+    partition_collector& operator= (partition_collector&&)      = delete;
+    ~partition_collector           (void)                       = default;
+
+    explicit partition_collector (partition_type& p)
+      : m_partition (p)
+    { }
+
+    // Returns the staging buffer of the calling thread. This takes a lock, so call it once per
+    // thread and keep the reference.
+    local_buffer&
+    local (void)
+    {
+      std::lock_guard<std::mutex> lock (m_mutex);
+      std::unique_ptr<local_buffer>& buf = m_buffers[std::this_thread::get_id ()];
+      if (! buf)
+      {
+        buf.reset (new local_buffer);
+        m_order.push_back (buf.get ());
+      }
+      return *buf;
+    }
+
+    // Appends every staged element to the back of its subrange and empties the staging buffers.
+    // Elements keep the order in which the threads first called `local`, and within a thread
+    // the order they were pushed. No thread may be producing while this runs.
+    void
+    collect (thread_pool& pool = thread_pool::default_pool ())
+    {
+      std::array<size_type, N> added { };
+      for (const local_buffer *buf : m_order)
+      {
+        for (std::size_t i = 0; i < N; ++i)
+          added[i] += buf->m_staged[i].size ();
+      }
+
+      m_partition.reserve_layout (added);
+
+      // where each buffer writes into each subrange
+      const auto first = m_partition.data_begin ();
+      partition_view<partition_type, N> views (m_partition);
+      std::vector<std::array<size_type, N>> positions (m_order.size ());
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        size_type pos = static_cast<size_type> (std::distance (first, views[i].end ())) - added[i];
+        for (std::size_t b = 0; b < m_order.size (); ++b)
+        {
+          positions[b][i] = pos;
+          pos += m_order[b]->m_staged[i].size ();
+        }
+      }
+
+      pool.parallel_for (m_order.size () * N,
+                         [&] (std::size_t task)
+                         {
+                           const std::size_t b = task / N;
+                           const std::size_t i = task % N;
+                           std::vector<T>& staged = m_order[b]->m_staged[i];
+                           std::move (staged.begin (), staged.end (),
+                                      std::next (first, static_cast<std::ptrdiff_t> (
+                                                          positions[b][i])));
+                           staged.clear ();
+                         });
+    }
+
+  private:
+    partition_type&                                                     m_partition;
+    std::mutex                                                          m_mutex;
+    std::unordered_map<std::thread::id, std::unique_ptr<local_buffer>> m_buffers;
+    std::vector<local_buffer *>                                         m_order;
+  };
+
+  namespace detail
+  {
+
+    // Writes chunk `t` of the input to positions `starts[t][k]` onward of subrange `k`, straight
+    // into a container sized once up front.
+    template <typename Container, typename Counts, typename ChunkBegin, typename KeyOf>
+    Container
+    scatter_chunks (thread_pool& pool, const std::vector<Counts>& starts, ChunkBegin& chunk_begin,
+                    KeyOf& key_of, typename Container::size_type len, std::true_type)
+    {
+      Container buffer (len);
+      pool.parallel_for (starts.size (),
+                         [&] (std::size_t t)
+                         {
+                           Counts next = starts[t];
+                           for (auto it = chunk_begin (t), e = chunk_begin (t + 1); it != e; ++it)
+                             buffer[next[key_of (*it)]++] = *it;
+                         });
+      return buffer;
+    }
+
+    // The elements can't be default constructed, so they are copy constructed in place in raw
+    // storage and then moved into the container.
+    template <typename Container, typename Counts, typename ChunkBegin, typename KeyOf>
+    Container
+    scatter_chunks (thread_pool& pool, const std::vector<Counts>& starts, ChunkBegin& chunk_begin,
+                    KeyOf& key_of, typename Container::size_type len, std::false_type)
+    {
+      using value_type = typename Container::value_type;
+      using size_type  = typename Container::size_type;
+      constexpr std::size_t N = std::tuple_size<Counts>::value;
+
+      // Each chunk writes every subrange front to back, so the elements it has constructed are
+      // [starts[t][k], ends[t][k]) for each `k`, even if it stopped partway.
+      uninitialized_buffer<value_type> scratch (len);
+      value_type *data = scratch.data ();
+      std::vector<Counts> ends (starts);
+      try
+      {
+        pool.parallel_for (starts.size (),
+                           [&] (std::size_t t)
+                           {
+                             Counts& next = ends[t];
+                             for (auto it = chunk_begin (t), e = chunk_begin (t + 1); it != e;
+                                  ++it)
+                             {
+                               size_type& i = next[key_of (*it)];
+                               ::new (static_cast<void *> (data + i)) value_type (*it);
+                               ++i;
+                             }
+                           });
+      }
+      catch (...)
+      {
+        for (std::size_t t = 0; t < starts.size (); ++t)
+        {
+          for (std::size_t k = 0; k < N; ++k)
+          {
+            for (size_type i = starts[t][k]; i != ends[t][k]; ++i)
+              data[i].~value_type ();
+          }
+        }
+        throw;
+      }
+
+      struct destroyer
+      {
+        ~destroyer (void)
+        {
+          for (value_type *p = first; p != last; ++p)
+            p->~value_type ();
+        }
+
+        value_type *first;
+        value_type *last;
+      } guard { data, data + len };
+
+      return Container (std::make_move_iterator (data), std::make_move_iterator (data + len));
+    }
+
+    // lets `parallel::sort_subranges` take a list partition apart and put it back together
+    struct list_partition_access
+    {
+      template <typename T, std::size_t N, typename C>
+      static
+      std::vector<C>
+      extract_subranges (list_partition<T, N, C>& p)
+      {
+        return p.extract_subranges ();
+      }
+
+      template <typename T, std::size_t N, typename C>
+      static
+      void
+      splice_subranges (list_partition<T, N, C>& p, std::vector<C>&& lists)
+      {
+        p.splice_subranges (std::move (lists));
+      }
+    };
+
+  } // namespace detail
+
+  // Builds a partition where element `x` of [first, last) lands in subrange `classify (x)`.
+  // The input is split into one chunk per thread of `pool`. Every chunk is counted, a prefix sum
+  // over the counts gives each chunk its write positions, and then the chunks are copied into
+  // place in parallel. If the value type is default constructible the container is sized once
+  // and the copies go straight into it. Otherwise they are constructed in raw storage and moved
+  // into the container afterwards, which costs a second buffer and a serial pass. The result is
+  // stable. `classify` is called twice per element and must give the same result both times.
+  template <std::size_t N, typename RandomIt, typename Classify,
+            typename Container = std::vector<typename std::iterator_traits<RandomIt>::value_type>>
+  vector_partition<typename Container::value_type, N, Container>
+  make_vector_partition (RandomIt first, RandomIt last, Classify classify,
+                         thread_pool& pool = thread_pool::default_pool ())
+  {
+    using value_type     = typename Container::value_type;
+    using partition_type = vector_partition<value_type, N, Container>;
+    using size_type      = typename partition_type::data_size_t;
+    using counts_type    = std::array<size_type, N>;
+
+    const size_type   len        = static_cast<size_type> (std::distance (first, last));
+    const std::size_t num_chunks = std::max<std::size_t> (std::min<std::size_t> (pool.size (), len),
+                                                          1);
+
+    auto chunk_begin = [&] (std::size_t t)
+                       {
+                         return std::next (first, static_cast<std::ptrdiff_t> (len * t
+                                                                               / num_chunks));
+                       };
+
+    auto key_of = [&] (const value_type& x)
+                  {
+                    const std::size_t k = classify (x);
+                    if (k >= N)
+                      throw std::out_of_range ("key is not a valid subrange index");
+                    return k;
+                  };
+
+    // per-chunk histograms
+    std::vector<counts_type> counts (num_chunks);
+    pool.parallel_for (num_chunks,
+                       [&] (std::size_t t)
+                       {
+                         counts_type local { };
+                         for (RandomIt it = chunk_begin (t), e = chunk_begin (t + 1); it != e; ++it)
+                           ++local[key_of (*it)];
+                         counts[t] = local;
+                       });
+
+    // turn the counts into the write positions of each chunk
+    counts_type sizes { };
+    size_type   pos = 0;
+    for (std::size_t k = 0; k < N; ++k)
+    {
+      for (counts_type& c : counts)
+      {
+        const size_type n = c[k];
+        c[k]      = pos;
+        pos      += n;
+        sizes[k] += n;
+      }
+    }
+
+    Container buffer = detail::scatter_chunks<Container> (
+      pool, counts, chunk_begin, key_of, len,
+      std::is_default_constructible<value_type> { });
+    return partition_type (std::move (buffer), sizes);
+  }
+
+  namespace detail
+  {
+
+    template <typename Partition, std::size_t N>
+    partition_view<Partition, N>
+    subrange_views (const partition_view<Partition, N>& v)
+    {
+      return v;
+    }
+
+    template <typename Partition>
+    auto
+    subrange_views (Partition& p)
+      -> decltype (p.get_partition_view ())
+    {
+      return p.get_partition_view ();
+    }
+
+    template <typename F>
+    using enable_if_not_pool_t =
+      typename std::enable_if<! std::is_same<typename std::decay<F>::type,
+                                             thread_pool>::value>::type;
+
+    template <typename Views>
+    using view_element_t = typename std::decay<decltype (std::declval<Views&> ()[0])>::type;
+
+    // Cuts the subranges into pieces small enough to keep every thread busy. Each piece is
+    // tagged with the index of the subrange it came from.
+    template <typename Views>
+    std::vector<std::pair<std::size_t, view_element_t<Views>>>
+    split_subranges (Views& views, std::size_t thread_count)
+    {
+      using view_type = view_element_t<Views>;
+      using diff_type = typename std::iterator_traits<decltype (views[0].begin ())>::difference_type;
+
+      std::size_t total = 0;
+      for (std::size_t i = 0; i < views.size (); ++i)
+        total += views[i].size ();
+
+      const std::size_t min_chunk = 1024;
+      const std::size_t chunk     = std::max (total / (4 * thread_count) + 1, min_chunk);
+
+      std::vector<std::pair<std::size_t, view_type>> ret;
+      for (std::size_t i = 0; i < views.size (); ++i)
+      {
+        auto first = views[i].begin ();
+        for (std::size_t remaining = views[i].size (); remaining != 0; )
+        {
+          const std::size_t n = std::min (remaining, chunk);
+          auto last = std::next (first, static_cast<diff_type> (n));
+          ret.emplace_back (i, view_type (first, last));
+          first      = last;
+          remaining -= n;
+        }
+      }
+      return ret;
+    }
+
+    // chunking of the flat data of a partition into equal-size pieces
+    struct flat_chunks
+    {
+      flat_chunks (std::size_t data_size, std::size_t thread_count) noexcept
+        : size  (std::max (data_size / (4 * thread_count) + 1, std::size_t { 1024 })),
+          count ((data_size + size - 1) / size)
+      { }
+
+      std::size_t size;
+      std::size_t count;
+    };
+
+    // Calls `f (c, first, last, i)` for every piece [first, last) of chunk `c` which lies in
+    // subrange `i`. The subrange containing the start of each chunk is found with a single binary
+    // search over the subrange offsets, and the rest are found by walking forward.
+    template <typename Partition, typename F>
+    void
+    for_each_flat_piece (Partition& p, const flat_chunks& chunks, thread_pool& pool, F& f)
+    {
+      auto views = subrange_views (p);
+      const auto first = p.data_begin ();
+      using diff_type = typename std::iterator_traits<decltype (p.data_begin ())>::difference_type;
+
+      // the offset of every subrange, followed by the data size
+      std::vector<diff_type> starts;
+      starts.reserve (views.size () + 1);
+      for (std::size_t i = 0; i < views.size (); ++i)
+        starts.push_back (std::distance (first, views[i].begin ()));
+      starts.push_back (static_cast<diff_type> (p.data_size ()));
+
+      const diff_type chunk_size = static_cast<diff_type> (chunks.size);
+      pool.parallel_for (chunks.count,
+                         [&] (std::size_t c)
+                         {
+                           diff_type       pos  = static_cast<diff_type> (c) * chunk_size;
+                           const diff_type last = std::min (pos + chunk_size, starts.back ());
+
+                           std::size_t i = static_cast<std::size_t> (
+                             std::upper_bound (starts.begin (), std::prev (starts.end ()), pos)
+                             - starts.begin ()) - 1;
+
+                           for (; pos != last; ++i)
+                           {
+                             const diff_type piece_last = std::min (starts[i + 1], last);
+                             if (pos != piece_last)
+                               f (c, std::next (first, pos), std::next (first, piece_last), i);
+                             pos = piece_last;
+                           }
+                         });
+    }
+
+  } // namespace detail
+
+  namespace parallel
+  {
+
+    // Calls `f (view)` with a view of each subrange, one task per subrange.
+    template <typename Partition, typename F>
+    void
+    for_each_subrange (Partition&& p, F f, thread_pool& pool = thread_pool::default_pool ())
+    {
+      auto views = detail::subrange_views (p);
+      pool.parallel_for (views.size (), [&] (std::size_t i) { f (views[i]); });
+    }
+
+    // Sorts every subrange, one task per subrange.
+    template <typename Partition, typename Compare,
+              typename = detail::enable_if_not_pool_t<Compare>>
+    void
+    sort_subranges (Partition&& p, Compare cmp, thread_pool& pool = thread_pool::default_pool ())
+    {
+      using view_type = detail::view_element_t<decltype (detail::subrange_views (p))>;
+      for_each_subrange (p, [&cmp] (view_type& v) { std::sort (v.begin (), v.end (), cmp); },
+                         pool);
+    }
+
+    // The subranges of a list are sorted as independent lists. Every subrange is spliced out,
+    // sorted by relinking nodes, and spliced back, so no element is copied or moved.
+    template <typename T, std::size_t N, typename C, typename Compare,
+              typename = detail::enable_if_not_pool_t<Compare>>
+    void
+    sort_subranges (list_partition<T, N, C>& p, Compare cmp,
+                    thread_pool& pool = thread_pool::default_pool ())
+    {
+      std::vector<C> lists = detail::list_partition_access::extract_subranges (p);
+      try
+      {
+        pool.parallel_for (N, [&] (std::size_t i) { lists[i].sort (cmp); });
+      }
+      catch (...)
+      {
+        detail::list_partition_access::splice_subranges (p, std::move (lists));
+        throw;
+      }
+      detail::list_partition_access::splice_subranges (p, std::move (lists));
+    }
+
+    template <typename Partition>
+    void
+    sort_subranges (Partition&& p, thread_pool& pool = thread_pool::default_pool ())
+    {
+      using view_type = detail::view_element_t<decltype (detail::subrange_views (p))>;
+      using value_type = typename std::iterator_traits<decltype (std::declval<view_type&> ()
+                                                                   .begin ())>::value_type;
+      sort_subranges (std::forward<Partition> (p), std::less<value_type> (), pool);
+    }
+
+    // Replaces every element `x` with `op (x)`. Large subranges are split across tasks.
+    template <typename Partition, typename UnaryOp>
+    void
+    transform_subranges (Partition&& p, UnaryOp op,
+                         thread_pool& pool = thread_pool::default_pool ())
+    {
+      auto views  = detail::subrange_views (p);
+      auto chunks = detail::split_subranges (views, pool.size ());
+      pool.parallel_for (chunks.size (),
+                         [&] (std::size_t c)
+                         {
+                           for (auto& x : chunks[c].second)
+                             x = op (x);
+                         });
+    }
+
+    // Returns `init op x0 op x1 op ...` for every subrange. `op` must be associative since large
+    // subranges are split across tasks and the partial results are combined in order.
+    template <typename Partition, typename U, typename BinaryOp>
+    std::vector<U>
+    reduce_subranges (Partition&& p, U init, BinaryOp op,
+                      thread_pool& pool = thread_pool::default_pool ())
+    {
+      auto views  = detail::subrange_views (p);
+      auto chunks = detail::split_subranges (views, pool.size ());
+
+      std::vector<U> partials (chunks.size (), init);
+      pool.parallel_for (chunks.size (),
+                         [&] (std::size_t c)
+                         {
+                           auto it = chunks[c].second.begin ();
+                           U acc = *it;
+                           for (++it; it != chunks[c].second.end (); ++it)
+                             acc = op (std::move (acc), *it);
+                           partials[c] = std::move (acc);
+                         });
+
+      std::vector<U> ret (views.size (), init);
+      for (std::size_t c = 0; c < chunks.size (); ++c)
+      {
+        U& r = ret[chunks[c].first];
+        r = op (std::move (r), std::move (partials[c]));
+      }
+      return ret;
+    }
+
+    // Calls `f (x, i)` for every element `x` of subrange `i`. Unlike `for_each_subrange`, the
+    // data is split into equal-size chunks, so skewed subrange sizes don't leave threads idle.
+    // Requires random access to the data.
+    template <typename Partition, typename F>
+    void
+    for_each (Partition&& p, F f, thread_pool& pool = thread_pool::default_pool ())
+    {
+      const detail::flat_chunks chunks (p.data_size (), pool.size ());
+      auto g = [&f] (std::size_t, decltype (p.data_begin ()) first,
+                     decltype (p.data_begin ()) last, std::size_t i)
+               {
+                 for (; first != last; ++first)
+                   f (*first, i);
+               };
+      detail::for_each_flat_piece (p, chunks, pool, g);
+    }
+
+    // Returns `init op transform (x0, i0) op transform (x1, i1) op ...` over the whole
+    // partition, where `i` is the subrange index of `x`. `op` must be associative. Split into
+    // equal-size chunks like `for_each`.
+    template <typename Partition, typename U, typename BinaryOp, typename Transform>
+    U
+    transform_reduce (Partition&& p, U init, BinaryOp op, Transform transform,
+                      thread_pool& pool = thread_pool::default_pool ())
+    {
+      const detail::flat_chunks chunks (p.data_size (), pool.size ());
+      std::vector<U>    partials (chunks.count, init);
+      std::vector<char> started  (chunks.count, 0);
+      auto g = [&] (std::size_t c, decltype (p.data_begin ()) first,
+                    decltype (p.data_begin ()) last, std::size_t i)
+               {
+                 if (! started[c])
+                 {
+                   partials[c] = transform (*first++, i);
+                   started[c]  = 1;
+                 }
+                 for (; first != last; ++first)
+                   partials[c] = op (std::move (partials[c]), transform (*first, i));
+               };
+      detail::for_each_flat_piece (p, chunks, pool, g);
+
+      for (U& partial : partials)
+        init = op (std::move (init), std::move (partial));
+      return init;
+    }
+
+  } // namespace parallel
+
+}
+
+#endif // PARTITION_PARALLEL_HPP
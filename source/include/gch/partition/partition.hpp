@@ -87,6 +87,8 @@
 #include <algorithm>
 #include <array>
 #include <functional>
+#include <memory>
+#include <new>
 
 #ifndef GCH_ALG_CONSTEXPR
 #  if defined (__cpp_lib_constexpr_algorithms) && __cpp_lib_constexpr_algorithms >= 201806L
@@ -155,6 +157,72 @@ namespace gch
     using match_cvref_t
       = match_ref_t<From, match_cv_t<typename std::remove_reference<From>::type, To>>;
 
+    // A fixed number of default constructed `T`s in storage aligned for `T`. Unlike `new T[n]`,
+    // this respects over-aligned types before C++17.
+    template <typename T>
+    class aligned_array
+    {
+    public:
+      aligned_array            (const aligned_array&) = delete;
+      aligned_array            (aligned_array&&)      = delete;
+      aligned_array& operator= (const aligned_array&) = delete;
+      aligned_array& operator= (aligned_array&&)      = delete;
+
+      explicit aligned_array (std::size_t count)
+        : m_storage (new unsigned char [count * sizeof (T) + alignof (T)]),
+          m_data    (nullptr),
+          m_size    (0)
+      {
+        void *p = m_storage.get ();
+        std::size_t space = count * sizeof (T) + alignof (T);
+        m_data = static_cast<T *> (std::align (alignof (T), count * sizeof (T), p, space));
+        try
+        {
+          for (; m_size < count; ++m_size)
+            ::new (static_cast<void *> (m_data + m_size)) T ();
+        }
+        catch (...)
+        {
+          destroy ();
+          throw;
+        }
+      }
+
+      ~aligned_array (void)
+      {
+        destroy ();
+      }
+
+      GCH_NODISCARD
+      T&
+      operator[] (std::size_t i) noexcept
+      {
+        return m_data[i];
+      }
+
+      GCH_NODISCARD T *begin (void) const noexcept { return m_data;          }
+      GCH_NODISCARD T *end   (void) const noexcept { return m_data + m_size; }
+
+      GCH_NODISCARD
+      std::size_t
+      size (void) const noexcept
+      {
+        return m_size;
+      }
+
+    private:
+      void
+      destroy (void) noexcept
+      {
+        while (m_size != 0)
+          m_data[--m_size].~T ();
+      }
+
+      std::unique_ptr<unsigned char []> m_storage;
+      T                                *m_data;
+      std::size_t                       m_size;
+    };
+
   } // namespace detail
 
   GCH_INLINE_VARIABLE constexpr std::size_t partition_base_index = static_cast<std::size_t> (-1);
@@ -785,7 +853,7 @@ namespace gch
     std::size_t
     size (void) const noexcept
     {
-      return std::distance (m_first, m_last);
+      return static_cast<std::size_t> (std::distance (m_first, m_last));
     }
 
     GCH_NODISCARD
@@ -860,6 +928,12 @@ namespace gch
       init_views<0> (p);
     }
 
+    // wraps views that were already computed, e.g. from a snapshot of the subrange boundaries
+    explicit
+    partition_view (const view_array_type& views)
+      : m_subrange_views (views)
+    { }
+
     // copy from view of `partition_type` to view of `const partition_type`
     template <typename NonConst,
               typename = typename std::enable_if<std::is_same<nonconst_partition_type,
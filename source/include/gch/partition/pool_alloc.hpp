@@ -0,0 +1,317 @@
+/** pool_alloc.hpp
+ * Short description here.
+ *
+ * Copyright © 2020 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef PARTITION_POOL_ALLOC_HPP
+#define PARTITION_POOL_ALLOC_HPP
+
+#include "partition.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+namespace gch
+{
+
+  namespace detail
+  {
+
+    // A process-wide pool of blocks of `Size` bytes. Each thread allocates from and frees to its own
+    // cache. The shared free list holds chains of `batch_size` blocks, so a thread only takes the
+    // lock to move a whole chain in or out of its cache, and that takes constant time. The shared
+    // free list is refilled with slabs that are kept for the life of the program.
+    template <std::size_t Size, std::size_t Align>
+    class node_pool
+    {
+      union block
+      {
+        struct
+        {
+          block *next;
+          block *next_chain;
+        } link;
+        typename std::aligned_storage<Size, Align>::type storage;
+      };
+
+      static constexpr std::size_t batch_size      = 64;
+      static constexpr std::size_t cache_limit     = 4 * batch_size;
+      static constexpr std::size_t min_slab_bytes  = 16 * 1024;
+      static constexpr std::size_t blocks_per_slab =
+        batch_size * ((min_slab_bytes / sizeof (block) + batch_size - 1) / batch_size);
+
+      struct shared_state
+      {
+        std::mutex          mutex;
+        block              *chains      = nullptr; // full chains, linked through `next_chain`
+        block              *loose       = nullptr; // fewer than `batch_size` blocks
+        std::size_t         loose_count = 0;
+        std::vector<void *> slabs;
+      };
+
+      // The cache itself is trivially destructible so that it is still usable while other
+      // thread-local objects are being destroyed.
+      struct thread_cache
+      {
+        block       *free  = nullptr;
+        std::size_t  count = 0;
+        bool         dead  = false;
+      };
+
+      // Returns the cache to the shared free list when the thread exits.
+      struct cache_flusher
+      {
+        cache_flusher            (void)                     = default;
+        cache_flusher            (const cache_flusher&)     = delete;
+        cache_flusher& operator= (const cache_flusher&)     = delete;
+
+        ~cache_flusher (void)
+        {
+          thread_cache& c = cache ();
+          while (c.count >= batch_size)
+            give_back (c);
+
+          while (c.free != nullptr)
+          {
+            block *b = c.free;
+            c.free = b->link.next;
+            give_back_one (b);
+          }
+          c.count = 0;
+          c.dead  = true;
+        }
+      };
+
+    public:
+      static void *
+      allocate (void)
+      {
+        thread_cache& c = cache ();
+        if (c.dead)
+          return take_one ();
+
+        if (c.free == nullptr)
+        {
+          attach_flusher ();
+          refill (c);
+        }
+
+        block *b = c.free;
+        c.free = b->link.next;
+        --c.count;
+        return b;
+      }
+
+      static void
+      deallocate (void *p) noexcept
+      {
+        block *b = static_cast<block *> (p);
+        thread_cache& c = cache ();
+        if (c.dead)
+          return give_back_one (b);
+
+        if (c.free == nullptr)
+          attach_flusher ();
+
+        b->link.next = c.free;
+        c.free = b;
+        if (++c.count > cache_limit)
+          give_back (c);
+      }
+
+    private:
+      static shared_state&
+      shared (void)
+      {
+        // never destroyed, so blocks may be freed during static destruction
+        static shared_state *s = new shared_state;
+        return *s;
+      }
+
+      static thread_cache&
+      cache (void) noexcept
+      {
+        static thread_local thread_cache c;
+        return c;
+      }
+
+      static void
+      attach_flusher (void) noexcept
+      {
+        static thread_local cache_flusher flusher;
+        static_cast<void> (flusher);
+      }
+
+      // Carves a new slab into chains in address order. Must be called with the lock held.
+      static void
+      add_slab (shared_state& s)
+      {
+        s.slabs.reserve (s.slabs.size () + 1);
+        block *slab = static_cast<block *> (::operator new (blocks_per_slab * sizeof (block)));
+        s.slabs.push_back (slab);
+
+        for (std::size_t i = blocks_per_slab; i != 0; i -= batch_size)
+        {
+          block *first = slab + (i - batch_size);
+          for (block *b = first; b != first + (batch_size - 1); ++b)
+            b->link.next = b + 1;
+          first[batch_size - 1].link.next = nullptr;
+
+          first->link.next_chain = s.chains;
+          s.chains = first;
+        }
+      }
+
+      // Must be called with the lock held.
+      static block *
+      pop_chain (shared_state& s)
+      {
+        if (s.chains == nullptr)
+          add_slab (s);
+
+        block *first = s.chains;
+        s.chains = first->link.next_chain;
+        return first;
+      }
+
+      // Must be called with the lock held.
+      static void
+      push_chain (shared_state& s, block *first) noexcept
+      {
+        first->link.next_chain = s.chains;
+        s.chains = first;
+      }
+
+      static void
+      refill (thread_cache& c)
+      {
+        shared_state& s = shared ();
+        std::lock_guard<std::mutex> lock (s.mutex);
+        c.free   = pop_chain (s);
+        c.count += batch_size;
+      }
+
+      // Moves the first `batch_size` blocks of the cache to the shared free list.
+      static void
+      give_back (thread_cache& c) noexcept
+      {
+        block *first = c.free;
+        block *last  = first;
+        for (std::size_t i = 1; i < batch_size; ++i)
+          last = last->link.next;
+        c.free = last->link.next;
+        last->link.next = nullptr;
+        c.count -= batch_size;
+
+        shared_state& s = shared ();
+        std::lock_guard<std::mutex> lock (s.mutex);
+        push_chain (s, first);
+      }
+
+      static void *
+      take_one (void)
+      {
+        shared_state& s = shared ();
+        std::lock_guard<std::mutex> lock (s.mutex);
+        if (s.loose == nullptr)
+        {
+          s.loose       = pop_chain (s);
+          s.loose_count = batch_size;
+        }
+
+        block *b = s.loose;
+        s.loose = b->link.next;
+        --s.loose_count;
+        return b;
+      }
+
+      static void
+      give_back_one (block *b) noexcept
+      {
+        shared_state& s = shared ();
+        std::lock_guard<std::mutex> lock (s.mutex);
+        b->link.next = s.loose;
+        s.loose = b;
+        if (++s.loose_count == batch_size)
+        {
+          push_chain (s, s.loose);
+          s.loose       = nullptr;
+          s.loose_count = 0;
+        }
+      }
+    };
+
+  }
+
+  // A stateless allocator that takes single objects from a pool of fixed-size blocks. It is meant
+  // for node-based containers, for example `list_partition<T, N, std::list<T, pool_alloc<T>>>`.
+  //
+  // Every `pool_alloc` with the same object size and alignment draws from the same pool, so any
+  // number of containers share it and elements may be spliced between them. Memory given to the
+  // pool is reused but never returned to the system. Arrays and over-aligned types are passed on
+  // to `std::allocator`.
+  template <typename T>
+  class pool_alloc
+  {
+    using pool_type = detail::node_pool<sizeof (T), alignof (T)>;
+
+    static constexpr bool is_pooled = alignof (T) <= alignof (std::max_align_t);
+
+  public:
+    using value_type                             = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap            = std::true_type;
+    using is_always_equal                        = std::true_type;
+
+    pool_alloc (void) noexcept = default;
+
+    template <typename U>
+    constexpr pool_alloc (const pool_alloc<U>&) noexcept { }
+
+    GCH_NODISCARD
+    T *
+    allocate (std::size_t n)
+    {
+      if (is_pooled && n == 1)
+        return static_cast<T *> (pool_type::allocate ());
+      return std::allocator<T> ().allocate (n);
+    }
+
+    void
+    deallocate (T *p, std::size_t n) noexcept
+    {
+      if (is_pooled && n == 1)
+        pool_type::deallocate (p);
+      else
+        std::allocator<T> ().deallocate (p, n);
+    }
+  };
+
+  template <typename T, typename U>
+  constexpr
+  bool
+  operator== (const pool_alloc<T>&, const pool_alloc<U>&) noexcept
+  {
+    return true;
+  }
+
+  template <typename T, typename U>
+  constexpr
+  bool
+  operator!= (const pool_alloc<T>&, const pool_alloc<U>&) noexcept
+  {
+    return false;
+  }
+
+}
+
+#endif // PARTITION_POOL_ALLOC_HPP
@@ -0,0 +1,200 @@
+/** seqlock_partition.hpp
+ * Short description here.
+ *
+ * Copyright © 2020 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef PARTITION_SEQLOCK_PARTITION_HPP
+#define PARTITION_SEQLOCK_PARTITION_HPP
+
+#include "partition.hpp"
+
+#include <array>
+#include <atomic>
+#include <iterator>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace gch
+{
+
+  // Guards the subrange boundaries of a contiguous partition with a sequence counter. One writer
+  // moves boundaries and never waits. Readers take consistent snapshots of the boundaries without
+  // locking; they only retry if a write happened while they were reading.
+  //
+  // Only the boundaries are guarded. The container is never resized here, so the iterators in a
+  // snapshot stay valid, but the elements themselves are not synchronized.
+  template <typename Partition>
+  class seqlock_partition
+  {
+  public:
+    using partition_type = Partition;
+    using data_citer     = typename partition_type::data_citer;
+    using data_size_t    = typename partition_type::data_size_t;
+    using data_diff_t    = typename partition_type::data_diff_t;
+    using view_type      = partition_view<const partition_type, partition_size<partition_type>::value>;
+
+    static constexpr std::size_t subrange_count = partition_size<partition_type>::value;
+
+    static_assert (std::is_base_of<std::random_access_iterator_tag,
+                                   typename std::iterator_traits<data_citer>::iterator_category>::value,
+                   "seqlock_partition requires a partition with contiguous storage.");
+
+  private:
+    // Makes the sequence odd while the writer is busy and publishes the boundaries when done.
+    class write_section
+    {
+    public:
+      explicit write_section (seqlock_partition& s) noexcept
+        : m_seqlock (s),
+          m_sequence (s.m_sequence.load (std::memory_order_relaxed))
+      {
+        m_seqlock.m_sequence.store (m_sequence + 1, std::memory_order_relaxed);
+      }
+
+      ~write_section (void)
+      {
+        m_seqlock.publish ();
+        m_seqlock.m_sequence.store (m_sequence + 2, std::memory_order_release);
+      }
+
+      write_section            (const write_section&) = delete;
+      write_section& operator= (const write_section&) = delete;
+
+    private:
+      seqlock_partition& m_seqlock;
+      std::size_t        m_sequence;
+    };
+
+  public:
+    seqlock_partition            (void)                         = delete;
+    seqlock_partition            (const seqlock_partition&)     = delete;
+    seqlock_partition            (seqlock_partition&&) noexcept = delete;
+    seqlock_partition& operator= (const seqlock_partition&)     = delete;
+    seqlock_partition& operator= (seqlock_partition&&) noexcept = delete;
+    ~seqlock_partition           (void)                         = default;
+
+    explicit seqlock_partition (partition_type p)
+      : m_partition (std::move (p)),
+        m_data_begin (static_cast<const partition_type&> (m_partition).data_begin ()),
+        m_data_size (static_cast<data_diff_t> (m_partition.data_size ()))
+    {
+      publish ();
+    }
+
+    // A consistent snapshot of every subrange. Never blocks.
+    GCH_NODISCARD
+    view_type
+    get_partition_view (void) const noexcept
+    {
+      std::array<data_diff_t, subrange_count> offsets;
+      read_consistent ([this, &offsets] (void) noexcept
+                       {
+                         for (std::size_t i = 0; i < subrange_count; ++i)
+                           offsets[i] = m_offsets[i].load (std::memory_order_acquire);
+                       });
+
+      typename view_type::view_array_type views;
+      for (std::size_t i = 0; i < subrange_count; ++i)
+      {
+        const data_diff_t last = (i + 1 < subrange_count) ? offsets[i + 1] : m_data_size;
+        views[i] = { std::next (m_data_begin, offsets[i]), std::next (m_data_begin, last) };
+      }
+      return view_type (views);
+    }
+
+    // A consistent snapshot of subrange `Index`. Never blocks.
+    template <std::size_t Index>
+    GCH_NODISCARD
+    subrange_view<data_citer>
+    get_subrange_view (void) const noexcept
+    {
+      static_assert (Index < subrange_count, "Invalid partition subrange index.");
+
+      data_diff_t first;
+      data_diff_t last;
+      read_consistent ([this, &first, &last] (void) noexcept
+                       {
+                         first = m_offsets[Index].load (std::memory_order_acquire);
+                         last  = (Index + 1 < subrange_count)
+                               ? m_offsets[Index + 1].load (std::memory_order_acquire)
+                               : m_data_size;
+                       });
+      return { std::next (m_data_begin, first), std::next (m_data_begin, last) };
+    }
+
+    // The following may only be called by one thread at a time.
+
+    template <std::size_t Index>
+    void
+    advance_begin (data_diff_t change)
+    {
+      write_section section (*this);
+      m_partition.template advance_begin<Index> (change);
+    }
+
+    template <std::size_t Index>
+    void
+    advance_end (data_diff_t change)
+    {
+      write_section section (*this);
+      m_partition.template advance_end<Index> (change);
+    }
+
+    // The sequence number only changes when the boundaries are written, so a reader can use it
+    // to tell whether a snapshot it already holds is stale.
+    GCH_NODISCARD
+    std::size_t
+    sequence (void) const noexcept
+    {
+      return m_sequence.load (std::memory_order_acquire);
+    }
+
+  private:
+    // The offsets are stored with release and loaded with acquire, so a reader that sees any
+    // offset from a write also sees the odd sequence number that began it.
+    template <typename Read>
+    void
+    read_consistent (Read read) const noexcept
+    {
+      while (true)
+      {
+        const std::size_t before = m_sequence.load (std::memory_order_acquire);
+        if ((before & 1) == 0)
+        {
+          read ();
+          if (m_sequence.load (std::memory_order_relaxed) == before)
+            return;
+        }
+        std::this_thread::yield ();
+      }
+    }
+
+    void
+    publish (void) noexcept
+    {
+      const view_type views (static_cast<const partition_type&> (m_partition).get_partition_view ());
+      for (std::size_t i = 0; i < subrange_count; ++i)
+      {
+        m_offsets[i].store (std::distance (m_data_begin, views[i].begin ()),
+                            std::memory_order_release);
+      }
+    }
+
+    partition_type                                       m_partition;
+    const data_citer                                     m_data_begin;
+    const data_diff_t                                    m_data_size;
+    std::atomic<std::size_t>                             m_sequence { 0 };
+    std::array<std::atomic<data_diff_t>, subrange_count> m_offsets;
+  };
+
+  template <typename Partition>
+  constexpr std::size_t seqlock_partition<Partition>::subrange_count;
+
+}
+
+#endif // PARTITION_SEQLOCK_PARTITION_HPP
@@ -0,0 +1,535 @@
+/** synchronized_partition.hpp
+ * Short description here.
+ *
+ * Copyright © 2020 Gene Harvey
+ *
+ * This software may be modified and distributed under the terms
+ * of the MIT license. See the LICENSE file for details.
+ * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * * */
+
+#ifndef PARTITION_SYNCHRONIZED_PARTITION_HPP
+#define PARTITION_SYNCHRONIZED_PARTITION_HPP
+
+#include "partition.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace gch
+{
+
+  template <typename T, std::size_t N, typename Container>
+  class vector_partition;
+
+  template <typename T, std::size_t N, typename Container>
+  class list_partition;
+
+  namespace detail
+  {
+
+    // A reader/writer lock, since std::shared_mutex isn't available before C++17. Waiting
+    // writers block new readers so that writers don't starve.
+    class rw_lock
+    {
+    public:
+      void
+      lock (void)
+      {
+        std::unique_lock<std::mutex> guard (m_mutex);
+        ++m_waiting_writers;
+        m_cv.wait (guard, [this] { return ! m_writer && m_readers == 0; });
+        --m_waiting_writers;
+        m_writer = true;
+      }
+
+      void
+      unlock (void)
+      {
+        {
+          std::lock_guard<std::mutex> guard (m_mutex);
+          m_writer = false;
+        }
+        m_cv.notify_all ();
+      }
+
+      void
+      lock_shared (void)
+      {
+        std::unique_lock<std::mutex> guard (m_mutex);
+        m_cv.wait (guard, [this] { return ! m_writer && m_waiting_writers == 0; });
+        ++m_readers;
+      }
+
+      void
+      unlock_shared (void)
+      {
+        bool last;
+        {
+          std::lock_guard<std::mutex> guard (m_mutex);
+          last = (--m_readers == 0);
+        }
+        if (last)
+          m_cv.notify_all ();
+      }
+
+    private:
+      std::mutex              m_mutex;
+      std::condition_variable m_cv;
+      std::size_t             m_readers         = 0;
+      std::size_t             m_waiting_writers = 0;
+      bool                    m_writer          = false;
+    };
+
+    // keeps neighboring locks off each other's cache lines
+    struct alignas (64) padded_rw_lock
+      : rw_lock
+    { };
+
+    // how far an operation on some subranges reaches into the state of the others
+    enum class lock_reach
+    {
+      // anything may move; lock every subrange
+      everything,
+      // elements live in one buffer and boundaries are offsets; moving a boundary touches the
+      // subranges on both sides of it, and changing a size may reallocate
+      contiguous,
+      // elements are nodes of one list and boundaries are iterators; changing the front of a
+      // subrange also touches the nearest nonempty subrange before it (its last node links to
+      // the front) and every empty subrange in between (they share the front as their boundary)
+      linked,
+    };
+
+    template <typename Partition>
+    struct partition_lock_reach
+      : std::integral_constant<lock_reach, lock_reach::everything>
+    { };
+
+    template <typename T, std::size_t N, typename Container>
+    struct partition_lock_reach<vector_partition<T, N, Container>>
+      : std::integral_constant<lock_reach, lock_reach::contiguous>
+    { };
+
+    template <typename T, std::size_t N, typename Container>
+    struct partition_lock_reach<list_partition<T, N, Container>>
+      : std::integral_constant<lock_reach, lock_reach::linked>
+    { };
+
+  } // namespace detail
+
+  // Wraps a partition with one reader/writer lock per subrange. Work on the elements of a single
+  // subrange only locks that subrange. All subranges share one container, so an operation that
+  // changes a size or moves a boundary can touch the state of other subranges; those operations
+  // lock exactly the subranges they reach, always in index order, so they can't deadlock. Which
+  // subranges are reached depends on the partition, see `detail::lock_reach`. Locking a range
+  // that depends on the sizes inside it (the nearest nonempty subrange, how far a boundary is
+  // carried) is done by locking a guess, checking it under the locks, and widening on a miss.
+  //
+  // The subranges of a `list_partition` share the size count of their `std::list`, so operations
+  // that change the number of elements also hold a mutex of their own for that count. Readers
+  // never take it.
+  template <typename Partition>
+  class synchronized_partition
+  {
+  public:
+    using partition_type = Partition;
+
+    template <std::size_t I>
+    using subrange_type = typename partition_type::template subrange_type<I>;
+
+    // the elements of subrange I, without the operations that resize or relink it
+    template <std::size_t I>
+    using view_type = decltype (std::declval<subrange_type<I>&> ().view ());
+
+    static constexpr std::size_t subrange_count = partition_size<partition_type>::value;
+
+  private:
+    using data_diff_t = typename partition_type::data_diff_t;
+
+    static constexpr detail::lock_reach reach = detail::partition_lock_reach<Partition>::value;
+
+    using reach_tag = std::integral_constant<detail::lock_reach, reach>;
+
+    template <detail::lock_reach R>
+    using reach_t = std::integral_constant<detail::lock_reach, R>;
+
+    // locks on the subranges [first, last], taken in index order
+    template <bool Shared>
+    class range_lock
+    {
+    public:
+      explicit range_lock (synchronized_partition& s) noexcept
+        : m_locks (s.m_locks)
+      { }
+
+      ~range_lock (void)
+      {
+        unlock ();
+      }
+
+      range_lock            (const range_lock&) = delete;
+      range_lock& operator= (const range_lock&) = delete;
+
+      void
+      lock (std::size_t first, std::size_t last)
+      {
+        m_first = first;
+        for (m_end = first; m_end <= last; ++m_end)
+        {
+          if (Shared)
+            m_locks[m_end].lock_shared ();
+          else
+            m_locks[m_end].lock ();
+        }
+      }
+
+      void
+      lock_all (void)
+      {
+        lock (0, subrange_count - 1);
+      }
+
+      void
+      unlock (void) noexcept
+      {
+        for (; m_end != m_first; --m_end)
+        {
+          if (Shared)
+            m_locks[m_end - 1].unlock_shared ();
+          else
+            m_locks[m_end - 1].unlock ();
+        }
+      }
+
+      GCH_NODISCARD
+      std::size_t
+      first (void) const noexcept
+      {
+        return m_first;
+      }
+
+    private:
+      std::array<detail::padded_rw_lock, subrange_count>& m_locks;
+      std::size_t                                         m_first = 0;
+      std::size_t                                         m_end   = 0;
+    };
+
+    template <bool Shared>
+    class one_lock
+    {
+    public:
+      one_lock (synchronized_partition& s, std::size_t i)
+        : m_lock (s.m_locks[i])
+      {
+        if (Shared)
+          m_lock.lock_shared ();
+        else
+          m_lock.lock ();
+      }
+
+      ~one_lock (void)
+      {
+        if (Shared)
+          m_lock.unlock_shared ();
+        else
+          m_lock.unlock ();
+      }
+
+      one_lock            (const one_lock&) = delete;
+      one_lock& operator= (const one_lock&) = delete;
+
+    private:
+      detail::rw_lock& m_lock;
+    };
+
+    using exclusive_lock = range_lock<false>;
+
+  public:
+    synchronized_partition            (void)                              = default;
+    synchronized_partition            (const synchronized_partition&)     = delete;
+    synchronized_partition            (synchronized_partition&&) noexcept = delete;
+    synchronized_partition& operator= (const synchronized_partition&)     = delete;
+    synchronized_partition& operator= (synchronized_partition&&) noexcept = delete;
+    ~synchronized_partition           (void)                              = default;
+
+    explicit synchronized_partition (partition_type p)
+      : m_partition (std::move (p))
+    { }
+
+    // Calls `f (subrange)` holding a shared lock on subrange I.
+    template <std::size_t I, typename F>
+    auto
+    read (F f)
+      -> decltype (f (std::declval<const subrange_type<I>&> ()))
+    {
+      one_lock<true> guard (*this, I);
+      return f (get_subrange<I> (static_cast<const partition_type&> (m_partition)));
+    }
+
+    // Calls `f (view)` holding an exclusive lock on subrange I. `f` gets a `view_type<I>`, so it
+    // may read and modify the elements but can neither resize the subrange nor relink its
+    // nodes, both of which reach other subranges; use `mutate` for that.
+    template <std::size_t I, typename F>
+    auto
+    write (F f)
+      -> decltype (f (std::declval<view_type<I>> ()))
+    {
+      one_lock<false> guard (*this, I);
+      return f (get_subrange<I> (m_partition).view ());
+    }
+
+    // Calls `f (subrange)` with exclusive locks on every subrange a change to subrange I can
+    // reach. `f` may do anything to subrange I itself (insert, erase, sort, splice within it),
+    // but must not touch other subranges. On a `list_partition` this locks subrange I and, since
+    // `f` may change its front, the subranges back to the nearest nonempty one. Anywhere else it
+    // locks every subrange.
+    template <std::size_t I, typename F>
+    auto
+    mutate (F f)
+      -> decltype (f (std::declval<subrange_type<I>&> ()))
+    {
+      exclusive_lock guard (*this);
+      if (reach == detail::lock_reach::linked)
+      {
+        lock_through_front (guard, I, I);
+        std::lock_guard<std::mutex> count_guard (m_count_mutex);
+        return f (get_subrange<I> (m_partition));
+      }
+      guard.lock_all ();
+      return f (get_subrange<I> (m_partition));
+    }
+
+    // Appends an element to subrange I. On a nonempty subrange of a `list_partition` this takes
+    // only the lock on subrange I.
+    template <std::size_t I, typename ...Args>
+    void
+    emplace_back (Args&&... args)
+    {
+      if (reach == detail::lock_reach::linked)
+      {
+        {
+          one_lock<false> guard (*this, I);
+          if (! get_subrange<I> (m_partition).empty ())
+          {
+            std::lock_guard<std::mutex> count_guard (m_count_mutex);
+            get_subrange<I> (m_partition).emplace_back (std::forward<Args> (args)...);
+            return;
+          }
+        }
+        // appending to an empty subrange changes its front
+        exclusive_lock guard (*this);
+        lock_through_front (guard, I, I);
+        std::lock_guard<std::mutex> count_guard (m_count_mutex);
+        get_subrange<I> (m_partition).emplace_back (std::forward<Args> (args)...);
+        return;
+      }
+      exclusive_lock guard (*this);
+      guard.lock_all ();
+      get_subrange<I> (m_partition).emplace_back (std::forward<Args> (args)...);
+    }
+
+    // Calls `f (partition)` holding a shared lock on every subrange.
+    template <typename F>
+    auto
+    read_all (F f)
+      -> decltype (f (std::declval<const partition_type&> ()))
+    {
+      range_lock<true> guard (*this);
+      guard.lock_all ();
+      return f (static_cast<const partition_type&> (m_partition));
+    }
+
+    // Calls `f (partition)` holding an exclusive lock on every subrange. Anything may be done
+    // to the partition here.
+    template <typename F>
+    auto
+    modify (F f)
+      -> decltype (f (std::declval<partition_type&> ()))
+    {
+      exclusive_lock guard (*this);
+      guard.lock_all ();
+      return f (m_partition);
+    }
+
+    // Moves the front of subrange I. Locks the subranges the boundary passes over and the one
+    // it borders on the other side.
+    template <std::size_t I>
+    void
+    advance_begin (data_diff_t change)
+    {
+      static_assert (0 < I && I < subrange_count, "subrange I has no movable front");
+
+      exclusive_lock guard (*this);
+      advance_begin<I> (guard, change, reach_tag ());
+    }
+
+    template <std::size_t I>
+    void
+    advance_end (data_diff_t change)
+    {
+      advance_begin<I + 1> (change);
+    }
+
+    // Exchanges the contents of subranges I and J. Locks the subranges from I to J, and on a
+    // `list_partition` also back to the nearest nonempty subrange before them.
+    template <std::size_t I, std::size_t J>
+    void
+    swap (void)
+    {
+      exclusive_lock guard (*this);
+      lock_between (guard, I, J);
+      get_subrange<I> (m_partition).swap (get_subrange<J> (m_partition));
+    }
+
+    // Moves every element of subrange J to the back of subrange I (for partitions with splice).
+    // Locks the same subranges as `swap`.
+    template <std::size_t I, std::size_t J>
+    void
+    splice (void)
+    {
+      exclusive_lock guard (*this);
+      lock_between (guard, I, J);
+      get_subrange<I> (m_partition).splice (get_subrange<I> (m_partition).cend (),
+                                            get_subrange<J> (m_partition));
+    }
+
+  private:
+    template <std::size_t I>
+    void
+    advance_begin (exclusive_lock& guard, data_diff_t change,
+                   reach_t<detail::lock_reach::everything>)
+    {
+      guard.lock_all ();
+      m_partition.template advance_begin<I> (change);
+    }
+
+    template <std::size_t I>
+    void
+    advance_begin (exclusive_lock& guard, data_diff_t change,
+                   reach_t<detail::lock_reach::contiguous>)
+    {
+      lock_passed (guard, I, change);
+      m_partition.template advance_begin<I> (change);
+    }
+
+    template <std::size_t I>
+    void
+    advance_begin (exclusive_lock& guard, data_diff_t change, reach_t<detail::lock_reach::linked>)
+    {
+      // the checked version counts every subrange on that side, not just the locked ones
+      if (! lock_passed (guard, I, change))
+        throw std::out_of_range ("The requested change of subrange offset is out of range.");
+      m_partition.template advance_begin_unchecked<I> (change);
+    }
+
+    template <std::size_t K = 0, typename std::enable_if<(K == subrange_count)>::type * = nullptr>
+    std::size_t
+    subrange_size (std::size_t) const noexcept
+    {
+      return 0;
+    }
+
+    // the size of subrange `i`, which must be locked
+    template <std::size_t K = 0, typename std::enable_if<(K < subrange_count)>::type * = nullptr>
+    std::size_t
+    subrange_size (std::size_t i) const noexcept
+    {
+      return (i == K) ? static_cast<std::size_t> (get_subrange<K> (m_partition).size ())
+                      : subrange_size<K + 1> (i);
+    }
+
+    void
+    lock_between (exclusive_lock& guard, std::size_t i, std::size_t j)
+    {
+      const std::size_t first = (std::min) (i, j);
+      const std::size_t last  = (std::max) (i, j);
+      if (reach == detail::lock_reach::everything)
+        guard.lock_all ();
+      else if (reach == detail::lock_reach::linked)
+        lock_through_front (guard, first, last);
+      else
+        guard.lock (first, last);
+    }
+
+    // Locks [p, last], where p is the nearest nonempty subrange before `i`, or 0 if there is
+    // none. That is every subrange a change to the front of a list subrange `i` reaches.
+    void
+    lock_through_front (exclusive_lock& guard, std::size_t i, std::size_t last)
+    {
+      std::size_t first = (i == 0) ? 0 : i - 1;
+      for (;;)
+      {
+        guard.lock (first, last);
+        std::size_t k = i;
+        while (k != first && subrange_size (k - 1) == 0)
+          --k;
+        if (k != first || first == 0)
+          return;
+
+        // everything locked before `i` is empty, so the nearest nonempty one is further left
+        guard.unlock ();
+        first = (first < i - first) ? 0 : first - (i - first);
+      }
+    }
+
+    // Locks the subranges a boundary at the front of subrange `i` passes over when it moves by
+    // `change`, and the one on its other side. Returns whether there are enough elements.
+    bool
+    lock_passed (exclusive_lock& guard, std::size_t i, data_diff_t change)
+    {
+      if (change < 0)
+        return lock_left (guard, i, static_cast<std::size_t> (-change));
+      return lock_right (guard, i, static_cast<std::size_t> (change));
+    }
+
+    // Locks [i - 1, j], where subranges i through j hold at least `count` elements, or through
+    // the last subrange if they don't. Returns whether they do.
+    bool
+    lock_right (exclusive_lock& guard, std::size_t i, std::size_t count)
+    {
+      for (std::size_t last = i;; ++last)
+      {
+        guard.lock (i - 1, last);
+        std::size_t passed = 0;
+        for (std::size_t k = i; k <= last && passed < count; ++k)
+          passed += subrange_size (k);
+        if (passed >= count || last + 1 == subrange_count)
+          return passed >= count;
+        guard.unlock ();
+      }
+    }
+
+    // Locks [j, i], where subranges j through i - 1 hold at least `count` elements, or from
+    // the first subrange if they don't. Returns whether they do.
+    bool
+    lock_left (exclusive_lock& guard, std::size_t i, std::size_t count)
+    {
+      for (std::size_t first = i - 1;; --first)
+      {
+        guard.lock (first, i);
+        std::size_t passed = 0;
+        for (std::size_t k = i; k != first && passed < count; --k)
+          passed += subrange_size (k - 1);
+        if (passed >= count || first == 0)
+          return passed >= count;
+        guard.unlock ();
+      }
+    }
+
+    partition_type                                     m_partition;
+    std::array<detail::padded_rw_lock, subrange_count> m_locks;
+    std::mutex                                         m_count_mutex;
+  };
+
+  template <typename Partition>
+  constexpr std::size_t synchronized_partition<Partition>::subrange_count;
+
+  template <typename Partition>
+  constexpr detail::lock_reach synchronized_partition<Partition>::reach;
+
+}
+
+#endif // PARTITION_SYNCHRONIZED_PARTITION_HPP
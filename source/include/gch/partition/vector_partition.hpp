@@ -13,7 +13,11 @@
 #include "partition.hpp"
 
 #include <algorithm>
+#include <array>
+#include <iterator>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 #ifndef GCH_CPP17_ALLOC_CONSTRUCT_NOEXCEPT
@@ -70,6 +74,7 @@ namespace gch
 
   protected:
     using next_type::m_container;
+    using next_type::m_offsets;
 
   public:
     partition_subrange            (void)                          = default;
@@ -93,32 +98,6 @@ namespace gch
     }
 
   protected:
-    template <std::size_t M, typename ...Subranges>
-    constexpr partition_subrange (const partition_subrange<vector_partition<T, M, Container>, 0>& other,
-                                       Subranges&&... subranges)
-      : next_type (0, next_subrange (other), std::forward<Subranges> (subranges)...)
-    { }
-
-    template <std::size_t M, typename ...Subranges>
-    constexpr partition_subrange (partition_subrange<vector_partition<T, M, Container>, 0>&& other,
-                                       Subranges&&... subranges)
-      : next_type (0, next_subrange (other), std::forward<Subranges> (subranges)...)
-    { }
-
-    template <std::size_t M, typename ...Subranges>
-    constexpr partition_subrange (vector_partition<T, M, Container>&& partition,
-                                       Subranges&&... subranges)
-      : partition_subrange (get_subrange<0> (partition),
-                                   std::forward<Subranges> (subranges)...)
-    { }
-
-    template <std::size_t M, typename ...Subranges>
-    constexpr partition_subrange (const vector_partition<T, M, Container>& partition,
-                                       Subranges&&... subranges)
-      : partition_subrange (get_subrange<0> (partition),
-                                   std::forward<Subranges> (subranges)...)
-    { }
-
     constexpr explicit partition_subrange (const alloc_ty& alloc)
       : next_type (alloc)
     { }
@@ -302,15 +281,71 @@ namespace gch
         erase (std::next (cbegin (), static_cast<diff_ty> (count)), cend ());
     }
 
-    template <std::size_t M, std::size_t J>
+    // The unordered operations do not preserve the order of elements in this subrange or any of
+    // the following subranges. In exchange, they only move one element per following subrange.
+
+    void unordered_push_back (const value_ty& val)
+    {
+      m_container.push_back (val);
+      next_type::cycle_back_left (0);
+    }
+
+    void unordered_push_back (value_ty&& val)
+    {
+      m_container.push_back (std::move (val));
+      next_type::cycle_back_left (0);
+    }
+
+    template <typename ...Args>
+    ref unordered_emplace_back (Args&&... args)
+    {
+      m_container.emplace_back (std::forward<Args> (args)...);
+      next_type::cycle_back_left (0);
+      return back ();
+    }
+
+    iter unordered_erase (const citer pos)
+    {
+      const diff_ty off = std::distance (m_container.cbegin (), pos);
+      const iter    it  = std::next (m_container.begin (), off);
+      const iter    lst = std::prev (end ());
+      if (it != lst)
+        std::iter_swap (it, lst);
+      next_type::cycle_hole_right (0);
+      return std::next (m_container.begin (), off);
+    }
+
+    // Moves the element at `pos` into subrange `J` by exchanging it with the elements at the
+    // boundaries in between. Like the unordered operations above, this does not preserve the
+    // order of the affected subranges.
+    template <std::size_t J, typename std::enable_if<(0 < J) && (J < N)>::type * = nullptr>
+    iter transfer (const citer pos, partition_subrange<partition_type, J>& dest)
+    {
+      this->check_same_partition (dest);
+      return next_type::pass_right (0, J, std::next (m_container.begin (),
+                                                       std::distance (m_container.cbegin (), pos)));
+    }
+
+    template <std::size_t J, typename std::enable_if<(J == 0)>::type * = nullptr>
+    iter transfer (const citer pos, partition_subrange<partition_type, J>& dest)
+    {
+      this->check_same_partition (dest);
+      return std::next (m_container.begin (), std::distance (m_container.cbegin (), pos));
+    }
+
+    template <std::size_t M, std::size_t J, typename std::enable_if<(M != N)>::type * = nullptr>
     void swap (partition_subrange<vector_partition<T, M, Container>, J>& other)
     {
-      if (&other == this)
-        return;
+      swap_through_buffer (other);
+    }
 
-      container_type tmp (std::make_move_iterator (begin ()), std::make_move_iterator (end ()));
-      assign (std::make_move_iterator (other.begin ()), std::make_move_iterator (other.end ()));
-      other.assign (std::make_move_iterator (tmp.begin ()), std::make_move_iterator (tmp.end ()));
+    template <std::size_t J>
+    void swap (partition_subrange<partition_type, J>& other)
+    {
+      if (&other.m_container == &m_container)
+        swap_in_place (other);
+      else
+        swap_through_buffer (other);
     }
 
     subrange_view<iter> view (void)
@@ -330,23 +365,42 @@ namespace gch
       return next_subrange (*this).advance_begin (change);
     }
 
-  protected:
-    void partition_swap (partition_subrange& other)
-      noexcept (noexcept (std::declval<next_type&> ().partition_swap (other)))
+  private:
+    void modify_offsets (diff_ty change) noexcept
     {
-      next_type::partition_swap (other);
+      next_type::add_to_offsets (1, N, change);
     }
 
-    constexpr diff_ty get_offset (void) const noexcept { return 0; }
+    template <std::size_t M, std::size_t J>
+    void swap_through_buffer (partition_subrange<vector_partition<T, M, Container>, J>& other)
+    {
+      container_type tmp (std::make_move_iterator (begin ()), std::make_move_iterator (end ()));
+      assign (std::make_move_iterator (other.begin ()), std::make_move_iterator (other.end ()));
+      other.assign (std::make_move_iterator (tmp.begin ()), std::make_move_iterator (tmp.end ()));
+    }
 
-  private:
-    void modify_offsets (diff_ty change)
+    // Both subranges are in the same buffer, so swap the shorter one with the front of the longer
+    // one, and rotate the remainder of the longer one past everything in between.
+    template <std::size_t J, typename std::enable_if<(0 < J)>::type * = nullptr>
+    void swap_in_place (partition_subrange<partition_type, J>& other)
     {
-      if (change == 0)
-        return;
+      const iter    a_first = begin ();
+      const iter    a_last  = end ();
+      const iter    b_first = other.begin ();
+      const iter    b_last  = other.end ();
+      const diff_ty a_size  = std::distance (a_first, a_last);
+      const diff_ty b_size  = std::distance (b_first, b_last);
 
-      next_subrange (*this).add_to_offset (change);
+      if (a_size <= b_size)
+        std::rotate (a_last, std::swap_ranges (a_first, a_last, b_first), b_last);
+      else
+        std::rotate (std::swap_ranges (b_first, b_last, a_first), a_last, b_last);
+
+      next_type::add_to_offsets (0 + 1, J + 1, b_size - a_size);
     }
+
+    template <std::size_t J, typename std::enable_if<(J == 0)>::type * = nullptr>
+    void swap_in_place (partition_subrange<partition_type, J>&) noexcept { }
   };
 
   template <typename T, std::size_t N, typename Container, std::size_t Index>
@@ -389,6 +443,7 @@ namespace gch
 
   protected:
     using next_type::m_container;
+    using next_type::m_offsets;
 
   public:
     partition_subrange            (void)                                 = default;
@@ -399,54 +454,6 @@ namespace gch
     ~partition_subrange           (void)                                 = default;
 
   protected:
-    template <std::size_t M, std::size_t J, typename ...Subranges,
-      typename std::enable_if<(J < M)>::type * = nullptr>
-    partition_subrange (size_ty accum,
-                        const partition_subrange<vector_partition<T, M, Container>, J>& other,
-                        Subranges&&... subranges)
-      : next_type (accum, next_subrange (other), std::forward<Subranges> (subranges)...),
-        m_offset (other.m_offset + static_cast<diff_ty> (accum))
-    { }
-
-    template <std::size_t M, typename ...Subranges>
-    partition_subrange (size_ty accum,
-                        const partition_subrange<vector_partition<T, M, Container>, M>& other,
-                        Subranges&&... subranges)
-      : partition_subrange (accum + other.m_container.size (),
-                            std::forward<Subranges> (subranges)...)
-    { }
-
-    template <std::size_t M, std::size_t J, typename ...Subranges,
-      typename std::enable_if<(J < M)>::type * = nullptr>
-    partition_subrange (size_ty accum,
-                        partition_subrange<vector_partition<T, M, Container>, J>&& other,
-                        Subranges&&... subranges)
-      : next_type (accum, next_subrange (other), std::forward<Subranges> (subranges)...),
-        m_offset (other.m_offset + accum)
-    { }
-
-    template <std::size_t M, typename ...Subranges>
-    partition_subrange (size_ty accum,
-                        partition_subrange<vector_partition<T, M, Container>, M>&& other,
-                        Subranges&&... subranges)
-      : partition_subrange (accum + other.m_container.size (),
-                            std::forward<Subranges> (subranges)...)
-    { }
-
-    template <std::size_t M, typename ...Subranges>
-    constexpr partition_subrange (size_ty accum, vector_partition<T, M, Container>&& partition,
-                                  Subranges&&... subranges)
-      : partition_subrange (accum, get_subrange<0> (partition),
-                            std::forward<Subranges> (subranges)...)
-    { }
-
-    template <std::size_t M, typename ...Subranges>
-    constexpr partition_subrange (size_ty accum, const vector_partition<T, M, Container>& partition,
-                                  Subranges&&... subranges)
-      : partition_subrange (accum, get_subrange<0> (partition),
-                            std::forward<Subranges> (subranges)...)
-    { }
-
     constexpr explicit partition_subrange (const alloc_ty& alloc)
       : next_type (alloc)
     { }
@@ -495,9 +502,9 @@ namespace gch
       assign (ilist.begin (), ilist.end ());
     }
 
-    GCH_NODISCARD GCH_CPP20_CONSTEXPR iter  begin  (void)       noexcept { return std::next (m_container.begin (), m_offset);   }
-    GCH_NODISCARD GCH_CPP20_CONSTEXPR citer begin  (void) const noexcept { return std::next (m_container.cbegin (), m_offset);  }
-    GCH_NODISCARD GCH_CPP20_CONSTEXPR citer cbegin (void) const noexcept { return std::next (m_container.cbegin (), m_offset);  }
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR iter  begin  (void)       noexcept { return std::next (m_container.begin (), m_offsets[Index]);   }
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR citer begin  (void) const noexcept { return std::next (m_container.cbegin (), m_offsets[Index]);  }
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR citer cbegin (void) const noexcept { return std::next (m_container.cbegin (), m_offsets[Index]);  }
 
     GCH_NODISCARD GCH_CPP20_CONSTEXPR iter   end     (void)       noexcept { return next_type::begin ();                        }
     GCH_NODISCARD GCH_CPP20_CONSTEXPR citer  end     (void) const noexcept { return next_type::cbegin ();                       }
@@ -507,9 +514,9 @@ namespace gch
     GCH_NODISCARD GCH_CPP20_CONSTEXPR criter rbegin  (void) const noexcept { return next_type::crend ();                        }
     GCH_NODISCARD GCH_CPP20_CONSTEXPR criter crbegin (void) const noexcept { return next_type::crend ();                        }
 
-    GCH_NODISCARD GCH_CPP20_CONSTEXPR riter  rend    (void)       noexcept { return std::prev (m_container.rend (), m_offset);  }
-    GCH_NODISCARD GCH_CPP20_CONSTEXPR criter rend    (void) const noexcept { return std::prev (m_container.crend (), m_offset); }
-    GCH_NODISCARD GCH_CPP20_CONSTEXPR criter crend   (void) const noexcept { return std::prev (m_container.crend (), m_offset); }
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR riter  rend    (void)       noexcept { return std::prev (m_container.rend (), m_offsets[Index]);  }
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR criter rend    (void) const noexcept { return std::prev (m_container.crend (), m_offsets[Index]); }
+    GCH_NODISCARD GCH_CPP20_CONSTEXPR criter crend   (void) const noexcept { return std::prev (m_container.crend (), m_offsets[Index]); }
 
     GCH_NODISCARD GCH_CPP14_CONSTEXPR ref&   front   (void)       noexcept { return *begin ();                                  }
     GCH_NODISCARD constexpr           cref&  front   (void) const noexcept { return *begin ();                                  }
@@ -641,15 +648,79 @@ namespace gch
         erase (std::next (cbegin (), static_cast<diff_ty> (count)), cend ());
     }
 
-    template <std::size_t M, std::size_t J>
+    // The unordered operations do not preserve the order of elements in this subrange or any of
+    // the following subranges. In exchange, they only move one element per following subrange.
+
+    void unordered_push_back (const value_ty& val)
+    {
+      m_container.push_back (val);
+      next_type::cycle_back_left (Index);
+    }
+
+    void unordered_push_back (value_ty&& val)
+    {
+      m_container.push_back (std::move (val));
+      next_type::cycle_back_left (Index);
+    }
+
+    template <typename ...Args>
+    ref unordered_emplace_back (Args&&... args)
+    {
+      m_container.emplace_back (std::forward<Args> (args)...);
+      next_type::cycle_back_left (Index);
+      return back ();
+    }
+
+    iter unordered_erase (const citer pos)
+    {
+      const diff_ty off = std::distance (m_container.cbegin (), pos);
+      const iter    it  = std::next (m_container.begin (), off);
+      const iter    lst = std::prev (end ());
+      if (it != lst)
+        std::iter_swap (it, lst);
+      next_type::cycle_hole_right (Index);
+      return std::next (m_container.begin (), off);
+    }
+
+    // Moves the element at `pos` into subrange `J` by exchanging it with the elements at the
+    // boundaries in between. Like the unordered operations above, this does not preserve the
+    // order of the affected subranges.
+    template <std::size_t J, typename std::enable_if<(Index < J) && (J < N)>::type * = nullptr>
+    iter transfer (const citer pos, partition_subrange<partition_type, J>& dest)
+    {
+      this->check_same_partition (dest);
+      return next_type::pass_right (Index, J, std::next (m_container.begin (),
+                                                       std::distance (m_container.cbegin (), pos)));
+    }
+
+    template <std::size_t J, typename std::enable_if<(J < Index)>::type * = nullptr>
+    iter transfer (const citer pos, partition_subrange<partition_type, J>& dest)
+    {
+      this->check_same_partition (dest);
+      return next_type::pass_left (Index, J, std::next (m_container.begin (),
+                                                      std::distance (m_container.cbegin (), pos)));
+    }
+
+    template <std::size_t J, typename std::enable_if<(J == Index)>::type * = nullptr>
+    iter transfer (const citer pos, partition_subrange<partition_type, J>& dest)
+    {
+      this->check_same_partition (dest);
+      return std::next (m_container.begin (), std::distance (m_container.cbegin (), pos));
+    }
+
+    template <std::size_t M, std::size_t J, typename std::enable_if<(M != N)>::type * = nullptr>
     void swap (partition_subrange<vector_partition<T, M, Container>, J>& other)
     {
-      if (&other == this)
-        return;
+      swap_through_buffer (other);
+    }
 
-      container_type tmp (std::make_move_iterator (begin ()), std::make_move_iterator (end ()));
-      assign (std::make_move_iterator (other.begin ()), std::make_move_iterator (other.end ()));
-      other.assign (std::make_move_iterator (tmp.begin ()), std::make_move_iterator (tmp.end ()));
+    template <std::size_t J>
+    void swap (partition_subrange<partition_type, J>& other)
+    {
+      if (&other.m_container == &m_container)
+        swap_in_place (other);
+      else
+        swap_through_buffer (other);
     }
 
     subrange_view<iter> view (void)
@@ -665,15 +736,13 @@ namespace gch
     iter advance_begin (diff_ty change)
     {
       // first case: past end, second case: past begin
-      if (((change > 0) && (change > static_cast<diff_ty> (m_container.size ()) - m_offset)) ||
-          ((change < 0) && (-change > m_offset)))
+      if (((change > 0)
+           && (change > static_cast<diff_ty> (m_container.size ()) - m_offsets[Index]))
+          || ((change < 0) && (-change > m_offsets[Index])))
         throw std::out_of_range ("requested change of subrange offset is out of range");
 
-      m_offset += change;
-      if (change > 0)
-        next_subrange (*this).propagate_offset_right (m_offset);
-      else
-        prev_subrange (*this).propagate_offset_left (m_offset);
+      m_offsets[Index] += change;
+      next_type::propagate_offset (Index);
       return begin ();
     }
 
@@ -686,55 +755,51 @@ namespace gch
     template <std::size_t J = Index, typename std::enable_if<(J == N - 1)>::type * = nullptr>
     iter advance_end (diff_ty change) = delete;
 
-  protected:
-    void partition_swap (partition_subrange& other)
-      noexcept (next_type::template is_nothrow_swappable<size_ty>::value &&
-                noexcept (std::declval<next_type&> ().partition_swap (other)))
-    {
-      using std::swap;
-      swap (m_offset, other.m_offset);
-      next_type::partition_swap (other);
-    }
-
-    constexpr diff_ty get_offset (void) const noexcept { return m_offset; }
-
   private:
-    void modify_offsets (diff_ty change)
+    void modify_offsets (diff_ty change) noexcept
     {
-      if (change == 0)
-        return;
-
-      next_subrange (*this).add_to_offset (change);
+      next_type::add_to_offsets (Index + 1, N, change);
     }
 
-    void add_to_offset (diff_ty change)
+    template <std::size_t M, std::size_t J>
+    void swap_through_buffer (partition_subrange<vector_partition<T, M, Container>, J>& other)
     {
-      next_subrange (*this).add_to_offset (change);
-      m_offset += change;
+      container_type tmp (std::make_move_iterator (begin ()), std::make_move_iterator (end ()));
+      assign (std::make_move_iterator (other.begin ()), std::make_move_iterator (other.end ()));
+      other.assign (std::make_move_iterator (tmp.begin ()), std::make_move_iterator (tmp.end ()));
     }
 
-    void propagate_offset_left (diff_ty pos_off) noexcept
+    // Both subranges are in the same buffer, so swap the shorter one with the front of the longer
+    // one, and rotate the remainder of the longer one past everything in between.
+    template <std::size_t J, typename std::enable_if<(Index < J)>::type * = nullptr>
+    void swap_in_place (partition_subrange<partition_type, J>& other)
     {
-      if (m_offset > pos_off)
-      {
-        m_offset = pos_off;
-        prev_subrange (*this).propagate_offset_left (pos_off);
-      }
+      const iter    a_first = begin ();
+      const iter    a_last  = end ();
+      const iter    b_first = other.begin ();
+      const iter    b_last  = other.end ();
+      const diff_ty a_size  = std::distance (a_first, a_last);
+      const diff_ty b_size  = std::distance (b_first, b_last);
+
+      if (a_size <= b_size)
+        std::rotate (a_last, std::swap_ranges (a_first, a_last, b_first), b_last);
+      else
+        std::rotate (std::swap_ranges (b_first, b_last, a_first), a_last, b_last);
+
+      next_type::add_to_offsets (Index + 1, J + 1, b_size - a_size);
     }
 
-    void propagate_offset_right (diff_ty pos_off) noexcept
+    template <std::size_t J, typename std::enable_if<(J < Index)>::type * = nullptr>
+    void swap_in_place (partition_subrange<partition_type, J>& other)
     {
-      if (m_offset < pos_off)
-      {
-        m_offset = pos_off;
-        next_subrange (*this).propagate_offset_right (pos_off);
-      }
+      other.swap_in_place (*this);
     }
 
-    diff_ty m_offset = 0;
+    template <std::size_t J, typename std::enable_if<(J == Index)>::type * = nullptr>
+    void swap_in_place (partition_subrange<partition_type, J>&) noexcept { }
   };
 
-  // end case holds the actual container
+  // end case holds the actual container and the offsets of all the subranges
   template <typename T, std::size_t N, typename Container>
   class partition_subrange<vector_partition<T, N, Container>, N>
   {
@@ -742,7 +807,7 @@ namespace gch
     friend class partition_subrange;
 
   public:
-    using partition_type = list_partition<T, N, Container>;
+    using partition_type = vector_partition<T, N, Container>;
     using subrange_type  = partition_subrange<partition_type, N>;
     using prev_type      = partition_subrange<partition_type, N - 1>;
 //  using next_type      = void;
@@ -771,6 +836,8 @@ namespace gch
     using value_ty = value_type;
     using alloc_ty = allocator_type;
 
+    using offset_array = std::array<diff_ty, N>;
+
   public:
     partition_subrange            (void)                          = default;
     partition_subrange            (const partition_subrange&)     = default;
@@ -780,24 +847,6 @@ namespace gch
     ~partition_subrange           (void)                          = default;
 
   protected:
-    template <std::size_t M>
-    GCH_CPP20_CONSTEXPR
-    partition_subrange (size_ty accum,
-                        const partition_subrange<vector_partition<T, M, Container>, M>& other)
-      : m_container { }
-    {
-      m_container.reserve (accum + other.m_container.size ());
-    }
-
-    template <std::size_t M>
-    GCH_CPP20_CONSTEXPR
-    partition_subrange (size_ty accum,
-                        partition_subrange<vector_partition<T, M, Container>, M>&& other)
-      : m_container { }
-    {
-      m_container.reserve (accum + other.m_container.size ());
-    }
-
     GCH_CPP20_CONSTEXPR explicit
     partition_subrange (const alloc_ty& alloc)
     GCH_CPP17_ALLOC_CONSTRUCT_NOEXCEPT
@@ -865,21 +914,427 @@ namespace gch
     {
       using std::swap;
       swap (m_container, other.m_container);
+      swap (m_offsets, other.m_offsets);
     }
 
-    constexpr
+    template <std::size_t J>
+    void
+    check_same_partition (const partition_subrange<partition_type, J>& other) const
+    {
+      if (&other.m_container != &m_container)
+        throw std::invalid_argument ("the subranges belong to different partitions");
+    }
+
+    // subrange N begins at the end of the container
     diff_ty
-    get_offset (void) const noexcept
+    get_offset (std::size_t idx) const noexcept
+    {
+      return idx < N ? m_offsets[idx] : static_cast<diff_ty> (m_container.size ());
+    }
+
+    void
+    assign_offsets (const std::array<size_ty, N>& sizes) noexcept
+    {
+      diff_ty pos = 0;
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        m_offsets[i] = pos;
+        pos += static_cast<diff_ty> (sizes[i]);
+      }
+    }
+
+    void
+    add_to_offsets (std::size_t first, std::size_t last, diff_ty change) noexcept
+    {
+      for (std::size_t i = first; i < last; ++i)
+        m_offsets[i] += change;
+    }
+
+    // pushes the neighboring offsets along after the offset of subrange `idx` was changed
+    void
+    propagate_offset (std::size_t idx) noexcept
+    {
+      const diff_ty pos = m_offsets[idx];
+      for (std::size_t i = idx + 1; i < N && m_offsets[i] < pos; ++i)
+        m_offsets[i] = pos;
+
+      for (std::size_t i = idx - 1; 0 < i && pos < m_offsets[i]; --i)
+        m_offsets[i] = pos;
+    }
+
+    // Moves the element at the back of the container to the end of subrange `idx` by exchanging
+    // it with the first element of every subrange in between.
+    void
+    cycle_back_left (std::size_t idx)
+    {
+      for (std::size_t i = N - 1; idx < i; --i)
+      {
+        const diff_ty pos = get_offset (i + 1) - 1;
+        if (pos != m_offsets[i])
+          std::iter_swap (std::next (m_container.begin (), m_offsets[i]),
+                          std::next (m_container.begin (), pos));
+        ++m_offsets[i];
+      }
+    }
+
+    // The inverse of the above. The element at the end of subrange `idx` is carried to the back
+    // of the container and popped.
+    void
+    cycle_hole_right (std::size_t idx)
+    {
+      for (std::size_t i = idx + 1; i < N; ++i)
+      {
+        --m_offsets[i];
+        const diff_ty pos = get_offset (i + 1) - 1;
+        if (pos != m_offsets[i])
+          std::iter_swap (std::next (m_container.begin (), m_offsets[i]),
+                          std::next (m_container.begin (), pos));
+      }
+      m_container.pop_back ();
+    }
+
+    // Carries the element at `it` in subrange `idx` into the front of subrange `dest`.
+    iter
+    pass_right (std::size_t idx, std::size_t dest, iter it)
+    {
+      for (std::size_t i = idx; i < dest; ++i)
+      {
+        const iter last = std::next (m_container.begin (), get_offset (i + 1) - 1);
+        if (it != last)
+          std::iter_swap (it, last);
+        --m_offsets[i + 1];
+        it = last;
+      }
+      return it;
+    }
+
+    // Carries the element at `it` in subrange `idx` into the back of subrange `dest`.
+    iter
+    pass_left (std::size_t idx, std::size_t dest, iter it)
+    {
+      for (std::size_t i = idx; dest < i; --i)
+      {
+        const iter first = std::next (m_container.begin (), m_offsets[i]);
+        if (it != first)
+          std::iter_swap (it, first);
+        ++m_offsets[i];
+        it = first;
+      }
+      return it;
+    }
+
+    template <std::size_t M>
+    void
+    append_partition (std::size_t idx,
+                      const partition_subrange<vector_partition<T, M, Container>, M>& other)
+    {
+      const diff_ty base = static_cast<diff_ty> (m_container.size ());
+      m_container.insert (m_container.end (), other.m_container.begin (),
+                          other.m_container.end ());
+      for (std::size_t j = 0; j < M; ++j)
+        m_offsets[idx + j] = base + other.m_offsets[j];
+    }
+
+    template <std::size_t M>
+    void
+    append_partition (std::size_t idx,
+                      partition_subrange<vector_partition<T, M, Container>, M>&& other)
+    {
+      const diff_ty base = static_cast<diff_ty> (m_container.size ());
+      m_container.insert (m_container.end (), std::make_move_iterator (other.m_container.begin ()),
+                          std::make_move_iterator (other.m_container.end ()));
+      for (std::size_t j = 0; j < M; ++j)
+        m_offsets[idx + j] = base + other.m_offsets[j];
+    }
+
+    // Appends each of `ranges` to the back of the corresponding subrange. The new layout is
+    // built in a buffer reserved to its final size, so every element is placed exactly once.
+    template <typename ...Ranges>
+    void
+    append_ranges (const Ranges&... ranges)
+    {
+      container_type tmp (m_container.get_allocator ());
+      tmp.reserve (m_container.size () + total_range_size (ranges...));
+
+      offset_array offsets { };
+      std::size_t  idx = 0;
+      try
+      {
+        using expander = int[];
+        static_cast<void> (expander { 0, (append_range (tmp, offsets, idx++, ranges), 0)... });
+      }
+      catch (...)
+      {
+        restore_relocated (tmp, offsets, idx);
+        throw;
+      }
+
+      using std::swap;
+      swap (m_container, tmp);
+      m_offsets = offsets;
+    }
+
+    // Removes every element for which `pred (elem, subrange_index)` is true in one stable sweep
+    // over the whole container. The offsets are rebuilt from the survivors of each subrange.
+    template <typename Pred>
+    size_ty
+    compact_if (Pred& pred)
+    {
+      offset_array offsets { };
+      iter dest = m_container.begin ();
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        offsets[i] = std::distance (m_container.begin (), dest);
+        const iter last = std::next (m_container.begin (), get_offset (i + 1));
+        for (iter it = std::next (m_container.begin (), m_offsets[i]); it != last; ++it)
+        {
+          if (! pred (*it, i))
+          {
+            if (dest != it)
+              *dest = std::move (*it);
+            ++dest;
+          }
+        }
+      }
+
+      const size_ty ret = static_cast<size_ty> (std::distance (dest, m_container.end ()));
+      m_container.erase (dest, m_container.end ());
+      m_offsets = offsets;
+      return ret;
+    }
+
+    // Moves every element into subrange `key (elem)`. A counting pass computes the new layout,
+    // then each element is swapped directly into its bucket (American flag sort). `key` must
+    // give the same result every time it sees the same element.
+    template <typename KeyFn>
+    void
+    permute_by_key (KeyFn& key)
+    {
+      offset_array starts { };
+      for (const value_ty& x : m_container)
+        ++starts[checked_key (key, x)];
+
+      diff_ty total = 0;
+      for (diff_ty& n : starts)
+      {
+        const diff_ty count = n;
+        n      = total;
+        total += count;
+      }
+
+      offset_array next (starts);
+      const iter first = m_container.begin ();
+      for (std::size_t i = 0; i < N; ++i)
+      {
+        const diff_ty last = (i + 1 < N) ? starts[i + 1] : total;
+        for (; next[i] < last; ++next[i])
+        {
+          const iter it = std::next (first, next[i]);
+          for (std::size_t k = key (*it); k != i; k = key (*it))
+            std::iter_swap (it, std::next (first, next[k]++));
+        }
+      }
+      m_offsets = starts;
+    }
+
+    // Same as above, but keeps the relative order of elements. The destination of every element
+    // is computed into a scratch buffer, then the permutation is applied in place by cycles.
+    template <typename KeyFn>
+    void
+    stable_permute_by_key (KeyFn& key)
     {
-      return static_cast<diff_ty> (m_container.size ());
+      std::vector<size_ty> dest;
+      dest.reserve (m_container.size ());
+
+      offset_array starts { };
+      for (const value_ty& x : m_container)
+      {
+        dest.push_back (checked_key (key, x));
+        ++starts[dest.back ()];
+      }
+
+      diff_ty total = 0;
+      for (diff_ty& n : starts)
+      {
+        const diff_ty count = n;
+        n      = total;
+        total += count;
+      }
+
+      offset_array next (starts);
+      for (size_ty& d : dest)
+        d = static_cast<size_ty> (next[d]++);
+
+      const iter first = m_container.begin ();
+      for (size_ty j = 0; j < dest.size (); ++j)
+      {
+        while (dest[j] != j)
+        {
+          const size_ty k = dest[j];
+          std::iter_swap (std::next (first, static_cast<diff_ty> (j)),
+                          std::next (first, static_cast<diff_ty> (k)));
+          std::swap (dest[j], dest[k]);
+        }
+      }
+      m_offsets = starts;
     }
 
   private:
-    static void add_to_offset          (diff_ty) noexcept { }
-    static void propagate_offset_right (diff_ty) noexcept { }
+    template <typename KeyFn>
+    static std::size_t
+    checked_key (KeyFn& key, const value_ty& x)
+    {
+      const std::size_t k = key (x);
+      if (k >= N)
+        throw std::out_of_range ("key is not a valid subrange index");
+      return k;
+    }
+
+  protected:
+    // Appends `counts[i]` value-initialized elements to subrange `i`. If the elements can be
+    // shifted without throwing, the gaps are opened in place from the back, so only the elements
+    // behind the first gap move, and the buffer grows at most once. Otherwise the layout is
+    // rebuilt like `append_ranges`. Either way a failure leaves the partition unchanged.
+    void
+    append_slots (const std::array<size_ty, N>& counts)
+    {
+      size_ty added = 0;
+      for (const size_ty n : counts)
+        added += n;
+
+      if (added == 0)
+        return;
+
+      using shift_in_place = std::integral_constant<bool,
+        std::is_nothrow_move_assignable<value_ty>::value
+        && std::is_nothrow_default_constructible<value_ty>::value>;
+      append_slots (counts, m_container.size () + added, shift_in_place { });
+    }
+
+  private:
+    // The old elements are only moved into a new buffer if they can be moved back without
+    // throwing. Otherwise they are copied, and the originals stay untouched until the swap.
+    using relocate_by_move = std::integral_constant<bool,
+      (std::is_nothrow_move_constructible<value_ty>::value
+       && std::is_nothrow_move_assignable<value_ty>::value)
+      || ! std::is_copy_constructible<value_ty>::value>;
+
+    template <typename Range>
+    void
+    append_range (container_type& tmp, offset_array& offsets, std::size_t idx, const Range& r)
+    {
+      offsets[idx] = static_cast<diff_ty> (tmp.size ());
+      relocate_subrange (tmp, idx, relocate_by_move { });
+      tmp.insert (tmp.end (), std::begin (r), std::end (r));
+    }
+
+    void
+    relocate_subrange (container_type& tmp, std::size_t idx, std::true_type)
+    {
+      tmp.insert (tmp.end (),
+                  std::make_move_iterator (std::next (m_container.begin (), get_offset (idx))),
+                  std::make_move_iterator (std::next (m_container.begin (), get_offset (idx + 1))));
+    }
+
+    void
+    relocate_subrange (container_type& tmp, std::size_t idx, std::false_type)
+    {
+      tmp.insert (tmp.end (), std::next (m_container.cbegin (), get_offset (idx)),
+                  std::next (m_container.cbegin (), get_offset (idx + 1)));
+    }
+
+    // Undoes the relocation of the first `count` subranges into `tmp` after a failure, so that
+    // the partition is left as it was. Copied elements were never touched, and move-only types
+    // that may throw cannot be restored.
+    void
+    restore_relocated (container_type& tmp, const offset_array& offsets, std::size_t count) noexcept
+    {
+      if (! std::is_nothrow_move_constructible<value_ty>::value
+          || ! std::is_nothrow_move_assignable<value_ty>::value)
+      {
+        return;
+      }
+
+      for (std::size_t i = 0; i < count; ++i)
+      {
+        const iter first = std::next (tmp.begin (), offsets[i]);
+        std::move (first, std::next (first, get_offset (i + 1) - get_offset (i)),
+                   std::next (m_container.begin (), get_offset (i)));
+      }
+    }
+
+    void
+    append_slots (const std::array<size_ty, N>& counts, size_ty new_size, std::true_type)
+    {
+      const diff_ty old_size = static_cast<diff_ty> (m_container.size ());
+      m_container.resize (new_size);
+
+      // `shift` is the number of slots opened in front of subrange `i`
+      diff_ty shift = static_cast<diff_ty> (new_size) - old_size;
+      diff_ty last  = old_size;
+      for (std::size_t i = N; i-- > 0;)
+      {
+        shift -= static_cast<diff_ty> (counts[i]);
+        const diff_ty first     = m_offsets[i];
+        const iter    dest_last = std::next (m_container.begin (), last + shift);
+        if (shift != 0)
+        {
+          std::move_backward (std::next (m_container.begin (), first),
+                              std::next (m_container.begin (), last), dest_last);
+        }
+
+        // the slots at the very back were value-initialized by the resize
+        if (i + 1 < N)
+        {
+          std::for_each (dest_last, std::next (dest_last, static_cast<diff_ty> (counts[i])),
+                         [] (value_ty& x) noexcept { x = value_ty (); });
+        }
+        m_offsets[i] = first + shift;
+        last = first;
+      }
+    }
+
+    void
+    append_slots (const std::array<size_ty, N>& counts, size_ty new_size, std::false_type)
+    {
+      container_type tmp (m_container.get_allocator ());
+      tmp.reserve (new_size);
+
+      offset_array offsets { };
+      std::size_t  idx = 0;
+      try
+      {
+        for (; idx < N; ++idx)
+        {
+          offsets[idx] = static_cast<diff_ty> (tmp.size ());
+          relocate_subrange (tmp, idx, relocate_by_move { });
+          tmp.resize (tmp.size () + counts[idx]);
+        }
+      }
+      catch (...)
+      {
+        restore_relocated (tmp, offsets, idx + 1);
+        throw;
+      }
+
+      using std::swap;
+      swap (m_container, tmp);
+      m_offsets = offsets;
+    }
+
+    template <typename Range, typename ...Ranges>
+    static size_ty
+    total_range_size (const Range& r, const Ranges&... rs)
+    {
+      return static_cast<size_ty> (std::distance (std::begin (r), std::end (r)))
+             + total_range_size (rs...);
+    }
+
+    static constexpr size_ty total_range_size (void) noexcept { return 0; }
 
   protected:
     container_type m_container;
+    offset_array   m_offsets { };
   };
 
   template <typename T, std::size_t N, typename C, std::size_t I>
@@ -918,6 +1373,37 @@ namespace gch
     return r;
   }
 
+  // Moves every element of subrange I that satisfies `pred` into the front of subrange I + 1.
+  // The elements are stably partitioned toward the shared boundary, which is then moved once.
+  template <typename T, std::size_t N, typename C, std::size_t I, typename Pred>
+  typename partition_subrange<vector_partition<T, N, C>, I>::size_type
+  promote_if (partition_subrange<vector_partition<T, N, C>, I>& s, Pred pred)
+  {
+    static_assert (I + 1 < N, "the last subrange cannot be promoted");
+    using subrange_type = partition_subrange<vector_partition<T, N, C>, I>;
+    auto it = std::stable_partition (s.begin (), s.end (),
+                                     [&pred] (typename subrange_type::const_reference x)
+                                     {
+                                       return ! pred (x);
+                                     });
+    auto r  = std::distance (it, s.end ());
+    s.advance_end (-r);
+    return static_cast<typename subrange_type::size_type> (r);
+  }
+
+  // Moves every element of subrange I that satisfies `pred` into the back of subrange I - 1.
+  template <typename T, std::size_t N, typename C, std::size_t I, typename Pred>
+  typename partition_subrange<vector_partition<T, N, C>, I>::size_type
+  demote_if (partition_subrange<vector_partition<T, N, C>, I>& s, Pred pred)
+  {
+    static_assert (0 < I && I < N, "the first subrange cannot be demoted");
+    auto it = std::stable_partition (s.begin (), s.end (), pred);
+    auto r  = std::distance (s.begin (), it);
+    s.advance_begin (r);
+    using subrange_type = partition_subrange<vector_partition<T, N, C>, I>;
+    return static_cast<typename subrange_type::size_type> (r);
+  }
+
   template <typename T, std::size_t N, typename Container>
   class vector_partition
     : public partition_traits<vector_partition<T, N, Container>>,
@@ -959,35 +1445,57 @@ namespace gch
     // concatenation constructor
     template <std::size_t M, typename ...Partitions>
     vector_partition (const vector_partition<T, M, Container>& p, Partitions&&... ps)
-      : first_type (get_subrange<0> (p), std::forward<Partitions> (ps)...)
     {
-      construct (p, std::forward<Partitions> (ps)...);
+      m_container.reserve (total_data_size (p, ps...));
+      construct (0, p, std::forward<Partitions> (ps)...);
     }
 
     template <std::size_t M, typename ...Partitions>
     vector_partition (vector_partition<T, M, Container>&& p, Partitions&&... ps)
-      : first_type (get_subrange<0> (p), std::forward<Partitions> (ps)...)
     {
-      construct (std::move (p), std::forward<Partitions> (ps)...);
+      m_container.reserve (total_data_size (p, ps...));
+      construct (0, std::move (p), std::forward<Partitions> (ps)...);
+    }
+
+    // takes over `c` and splits it into subranges of the given sizes
+    vector_partition (container_type&& c, const std::array<data_size_t, N>& sizes)
+    {
+      m_container = std::move (c);
+      set_boundaries (sizes);
+    }
+
+    // constructs each subrange from the corresponding range
+    template <typename ...Ranges>
+    explicit vector_partition (std::piecewise_construct_t, const Ranges&... ranges)
+    {
+      insert_many (ranges...);
     }
 
   private:
     template <std::size_t M, typename ...Partitions>
-    void construct (const vector_partition<T, M, Container>& p, Partitions&&... ps)
+    void construct (std::size_t idx, const vector_partition<T, M, Container>& p,
+                    Partitions&&... ps)
     {
-      m_container.insert (m_container.cend (), p.data_begin (), p.data_end ());
-      construct (std::forward<Partitions> (ps)...);
+      last_type::append_partition (idx, get_subrange<M> (p));
+      construct (idx + M, std::forward<Partitions> (ps)...);
     }
 
     template <std::size_t M, typename ...Partitions>
-    void construct (vector_partition<T, M, Container>&& p, Partitions&&... ps)
+    void construct (std::size_t idx, vector_partition<T, M, Container>&& p, Partitions&&... ps)
     {
-      m_container.insert (m_container.cend (), std::make_move_iterator (p.data_begin ()),
-                          std::make_move_iterator (p.data_end ()));
-      construct (std::forward<Partitions> (ps)...);
+      last_type::append_partition (idx, get_subrange<M> (std::move (p)));
+      construct (idx + M, std::forward<Partitions> (ps)...);
     }
 
-    static void construct (void) noexcept { }
+    static void construct (std::size_t) noexcept { }
+
+    template <typename P, typename ...Partitions>
+    static data_size_t total_data_size (const P& p, const Partitions&... ps) noexcept
+    {
+      return p.data_size () + total_data_size (ps...);
+    }
+
+    static constexpr data_size_t total_data_size (void) noexcept { return 0; }
 
   public:
     constexpr explicit vector_partition (const data_alloc_t& alloc)
@@ -1004,6 +1512,16 @@ namespace gch
     get_partition_t<SubrangeRef>
     get_partition (SubrangeRef&& s) noexcept;
 
+    template <typename U, std::size_t M, typename C, typename Pred>
+    friend typename vector_partition<U, M, C>::data_size_t
+    erase_if_indexed (vector_partition<U, M, C>& p, Pred pred);
+
+    template <typename U, std::size_t M, typename C, typename KeyFn>
+    friend void repartition (vector_partition<U, M, C>& p, KeyFn key);
+
+    template <typename U, std::size_t M, typename C, typename KeyFn>
+    friend void stable_repartition (vector_partition<U, M, C>& p, KeyFn key);
+
     GCH_CPP14_CONSTEXPR subrange_type<0> front (void) noexcept
     {
       return get_subrange<0> (*this);
@@ -1106,6 +1624,58 @@ namespace gch
       return get_subrange<Index> (*this).advance_end (change);
     }
 
+    // Appends each range to the back of the corresponding subrange. The final layout is computed
+    // up front, so this reserves once and places every element in a single pass.
+    template <typename ...Ranges>
+    void
+    insert_many (const Ranges&... ranges)
+    {
+      static_assert (sizeof...(Ranges) == N, "insert_many takes exactly one range per subrange");
+      last_type::append_ranges (ranges...);
+    }
+
+    // Appends `counts[i]` value-initialized elements to the back of every subrange `i` with at
+    // most one allocation. This is the first phase of `concurrent_fill`.
+    void
+    reserve_layout (const std::array<data_size_t, N>& counts)
+    {
+      last_type::append_slots (counts);
+    }
+
+    // Resizes every subrange at once without moving any elements. The sizes must add up to
+    // `data_size ()`.
+    void
+    set_boundaries (const std::array<data_size_t, N>& sizes)
+    {
+      data_size_t total = 0;
+      for (const data_size_t n : sizes)
+        total += n;
+
+      if (total != data_size ())
+        throw std::invalid_argument ("subrange sizes do not add up to the data size");
+
+      last_type::assign_offsets (sizes);
+    }
+
+    template <typename Iterator>
+    void
+    set_boundaries (Iterator first, Iterator last)
+    {
+      std::array<data_size_t, N> sizes;
+      auto it = sizes.begin ();
+      for (; first != last; ++first, ++it)
+      {
+        if (it == sizes.end ())
+          throw std::invalid_argument ("expected exactly one size per subrange");
+        *it = static_cast<data_size_t> (*first);
+      }
+
+      if (it != sizes.end ())
+        throw std::invalid_argument ("expected exactly one size per subrange");
+
+      set_boundaries (sizes);
+    }
+
     void
     swap (vector_partition& other)
       noexcept (noexcept (std::declval<vector_partition&> ().partition_swap (other)))
@@ -1153,6 +1723,44 @@ namespace gch
     lhs.swap (rhs);
   }
 
+  // Erases every element `x` in subrange `i` for which `pred (x, i)` is true. The whole partition
+  // is compacted in a single pass.
+  template <typename T, std::size_t N, typename C, typename Pred>
+  typename vector_partition<T, N, C>::data_size_t
+  erase_if_indexed (vector_partition<T, N, C>& p, Pred pred)
+  {
+    return p.last_type::compact_if (pred);
+  }
+
+  template <typename T, std::size_t N, typename C, typename Pred>
+  typename vector_partition<T, N, C>::data_size_t
+  erase_if (vector_partition<T, N, C>& p, Pred pred)
+  {
+    return erase_if_indexed (p, [&pred] (typename vector_partition<T, N, C>::data_ref x,
+                                         std::size_t)
+                                {
+                                  return pred (x);
+                                });
+  }
+
+  // Moves every element `x` into subrange `key (x)` in O(n) without allocating. The order of
+  // elements within a subrange is unspecified.
+  template <typename T, std::size_t N, typename C, typename KeyFn>
+  void
+  repartition (vector_partition<T, N, C>& p, KeyFn key)
+  {
+    p.last_type::permute_by_key (key);
+  }
+
+  // Same as `repartition`, but keeps the relative order of elements. Uses one scratch buffer of
+  // indices.
+  template <typename T, std::size_t N, typename C, typename KeyFn>
+  void
+  stable_repartition (vector_partition<T, N, C>& p, KeyFn key)
+  {
+    p.last_type::stable_permute_by_key (key);
+  }
+
   template <typename T, typename C, std::size_t N, std::size_t I, std::size_t M, std::size_t J>
   GCH_ALG_CONSTEXPR bool operator== (const partition_subrange<vector_partition<T, N, C>, I>& lhs,
                                      const partition_subrange<vector_partition<T, M, C>, J>& rhs)
@@ -9,17 +9,31 @@
 
 #include <gch/partition/partition.hpp>
 #include <gch/partition/dependent_partition.hpp>
+#include <gch/partition/dynamic_vector_partition.hpp>
+#include <gch/partition/epoch_partition.hpp>
+#include <gch/partition/gap_vector_partition.hpp>
+#include <gch/partition/indexed_list_partition.hpp>
 #include <gch/partition/list_partition.hpp>
+#include <gch/partition/parallel.hpp>
+#include <gch/partition/pool_alloc.hpp>
+#include <gch/partition/seqlock_partition.hpp>
+#include <gch/partition/synchronized_partition.hpp>
 #include <gch/partition/vector_partition.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <iostream>
+#include <array>
+#include <functional>
 #include <list>
+#include <numeric>
 #include <tuple>
 #include <string>
 #include <iterator>
 #include <chrono>
 #include <forward_list>
+#include <stdexcept>
+#include <vector>
 
 #if defined (__cpp_concepts) && __cpp_concepts >= 201907L
 #  ifndef GCH_CONCEPTS
@@ -231,6 +245,16 @@ namespace gch
   template class partition_subrange<vector_partition<std::string, 4>, 3>;
   template class partition_subrange<vector_partition<std::string, 4>, 4>;
 
+  template class gap_vector_partition<std::string, 4>;
+  template class partition_subrange<gap_vector_partition<std::string, 4>, 0>;
+  template class partition_subrange<gap_vector_partition<std::string, 4>, 1>;
+  template class partition_subrange<gap_vector_partition<std::string, 4>, 2>;
+  template class partition_subrange<gap_vector_partition<std::string, 4>, 3>;
+  template class partition_subrange<gap_vector_partition<std::string, 4>, 4>;
+
+  template class dynamic_vector_partition<std::string>;
+  template class dynamic_subrange<dynamic_vector_partition<std::string>>;
+
   // template class list_partition<std::string, 4, std::forward_list<std::string>>;
 }
 
@@ -1171,6 +1195,907 @@ do_test_enum_access (void)
 #endif
 }
 
+using contents = std::vector<std::vector<int>>;
+
+// Reports a failed expectation. Returns whether it held, so that a test can collect its results
+// with `&=` and still run the rest of its checks.
+static
+bool
+expect (bool holds, const char *what, int line)
+{
+  if (! holds)
+    std::cerr << "main.cpp:" << line << ": expected " << what << std::endl;
+  return holds;
+}
+
+#define EXPECT(...) expect (static_cast<bool> (__VA_ARGS__), #__VA_ARGS__, __LINE__)
+
+// the elements of every subrange of a partition view, in order
+template <typename View>
+static
+contents
+contents_of (const View& v)
+{
+  contents ret;
+  for (const auto& sub : v)
+  {
+    ret.emplace_back ();
+    for (const auto& x : sub)
+      ret.back ().push_back (static_cast<int> (x));
+  }
+  return ret;
+}
+
+// for the unordered operations, which only promise which elements end up in a subrange
+template <typename View>
+static
+contents
+sorted_contents_of (const View& v)
+{
+  contents ret = contents_of (v);
+  for (std::vector<int>& sub : ret)
+    std::sort (sub.begin (), sub.end ());
+  return ret;
+}
+
+template <typename Subrange>
+static
+typename Subrange::iterator
+find_in (Subrange& s, int x)
+{
+  return std::find (s.begin (), s.end (), x);
+}
+
+// Copying or default-constructing a `fragile` throws once `fragile_budget` such operations have
+// succeeded, which drives the rollback paths. A negative budget never runs out. Moves only spend
+// the budget if they are allowed to throw.
+static int fragile_budget = -1;
+
+static
+void
+spend_fragile_budget (void)
+{
+  if (fragile_budget == 0)
+    throw std::runtime_error ("fragile budget exhausted");
+  if (fragile_budget > 0)
+    --fragile_budget;
+}
+
+template <bool NothrowMove>
+struct fragile
+{
+  fragile (void)
+    : value (0)
+  {
+    spend_fragile_budget ();
+  }
+
+  /* implicit */ fragile (int v) noexcept
+    : value (v)
+  { }
+
+  fragile (const fragile& other)
+    : value (other.value)
+  {
+    spend_fragile_budget ();
+  }
+
+  fragile (fragile&& other) noexcept (NothrowMove)
+    : value (other.value)
+  {
+    if (! NothrowMove)
+      spend_fragile_budget ();
+  }
+
+  fragile&
+  operator= (const fragile& other)
+  {
+    spend_fragile_budget ();
+    value = other.value;
+    return *this;
+  }
+
+  fragile&
+  operator= (fragile&& other) noexcept (NothrowMove)
+  {
+    if (! NothrowMove)
+      spend_fragile_budget ();
+    value = other.value;
+    return *this;
+  }
+
+  explicit operator int (void) const noexcept
+  {
+    return value;
+  }
+
+  int value;
+};
+
+// Runs `op` on a fresh partition from `make` with a budget of 0, 1, 2, ... until it succeeds.
+// Every attempt that throws must leave the partition as it was.
+template <typename Make, typename Op>
+static
+bool
+expect_rollback (Make make, Op op, int line)
+{
+  bool ok = true;
+  for (int budget = 0;; ++budget)
+  {
+    auto p = make ();
+    const contents before = contents_of (p.get_partition_view ());
+    fragile_budget = budget;
+    try
+    {
+      op (p);
+      fragile_budget = -1;
+      return ok & expect (budget != 0, "the operation to throw at least once", line);
+    }
+    catch (const std::runtime_error&)
+    {
+      fragile_budget = -1;
+      ok &= expect (contents_of (p.get_partition_view ()) == before,
+                    "a failed operation to leave the partition unchanged", line);
+    }
+  }
+}
+
+static
+bool
+do_test_unordered_ops (void)
+{
+  bool ok = true;
+  vector_partition<int, 3> p;
+  get_subrange<0> (p).unordered_push_back (1);
+  get_subrange<2> (p).unordered_push_back (7);
+  get_subrange<2> (p).unordered_emplace_back (9);
+  get_subrange<1> (p).unordered_push_back (17);
+  get_subrange<0> (p).unordered_emplace_back (3);
+  ok &= EXPECT (sorted_contents_of (p.get_partition_view ()) == contents { { 1, 3 }, { 17 }, { 7, 9 } });
+
+  get_subrange<0> (p).unordered_erase (find_in (get_subrange<0> (p), 1));
+  ok &= EXPECT (sorted_contents_of (p.get_partition_view ()) == contents { { 3 }, { 17 }, { 7, 9 } });
+
+  get_subrange<1> (p).unordered_erase (find_in (get_subrange<1> (p), 17));
+  ok &= EXPECT (sorted_contents_of (p.get_partition_view ()) == contents { { 3 }, { }, { 7, 9 } });
+
+  get_subrange<2> (p).unordered_erase (find_in (get_subrange<2> (p), 7));
+  ok &= EXPECT (sorted_contents_of (p.get_partition_view ()) == contents { { 3 }, { }, { 9 } });
+  return ok;
+}
+
+static
+bool
+do_test_transfer (void)
+{
+  bool ok = true;
+  vector_partition<int, 3> p (std::piecewise_construct, std::vector<int> { 3 }, std::vector<int> { },
+                              std::vector<int> { 9, 11, 13 });
+
+  get_subrange<0> (p).transfer (get_subrange<0> (p).begin (), get_subrange<2> (p));
+  ok &= EXPECT (sorted_contents_of (p.get_partition_view ()) == contents { { }, { }, { 3, 9, 11, 13 } });
+
+  get_subrange<2> (p).transfer (find_in (get_subrange<2> (p), 9), get_subrange<1> (p));
+  ok &= EXPECT (sorted_contents_of (p.get_partition_view ()) == contents { { }, { 9 }, { 3, 11, 13 } });
+
+  get_subrange<2> (p).transfer (find_in (get_subrange<2> (p), 3), get_subrange<0> (p));
+  ok &= EXPECT (sorted_contents_of (p.get_partition_view ()) == contents { { 3 }, { 9 }, { 11, 13 } });
+
+  bool thrown = false;
+  try
+  {
+    decltype (p) other;
+    get_subrange<0> (p).transfer (get_subrange<0> (p).begin (), get_subrange<2> (other));
+  }
+  catch (const std::invalid_argument&)
+  {
+    thrown = true;
+  }
+  ok &= EXPECT (thrown);
+  ok &= EXPECT (sorted_contents_of (p.get_partition_view ()) == contents { { 3 }, { 9 }, { 11, 13 } });
+  return ok;
+}
+
+static
+bool
+do_test_subrange_swap (void)
+{
+  bool ok = true;
+  vector_partition<int, 3> p (std::piecewise_construct, std::vector<int> { 3 },
+                              std::vector<int> { 9 }, std::vector<int> { 11, 13 });
+  get_subrange<0> (p).swap (get_subrange<2> (p));
+  ok &= EXPECT (contents_of (p.get_partition_view ()) == contents { { 11, 13 }, { 9 }, { 3 } });
+
+  get_subrange<2> (p).swap (get_subrange<1> (p));
+  ok &= EXPECT (contents_of (p.get_partition_view ()) == contents { { 11, 13 }, { 3 }, { 9 } });
+
+  gap_vector_partition<int, 3> g;
+  get_subrange<0> (g).push_back (1);
+  get_subrange<2> (g).push_back (5);
+  get_subrange<2> (g).push_back (6);
+  get_subrange<2> (g).push_back (7);
+  get_subrange<0> (g).swap (get_subrange<2> (g));
+  ok &= EXPECT (contents_of (g.get_partition_view ()) == contents { { 5, 6, 7 }, { }, { 1 } });
+  return ok;
+}
+
+static
+bool
+do_test_insert_many (void)
+{
+  bool ok = true;
+  vector_partition<int, 3> p (std::piecewise_construct, std::vector<int> { 11, 13 },
+                              std::vector<int> { 3 }, std::vector<int> { 9 });
+  const std::vector<int>   r0 { 2, 4 };
+  const std::list<int>     r1 { 6 };
+  const std::array<int, 3> r2 { { 8, 10, 12 } };
+  p.insert_many (r0, r1, r2);
+  ok &= EXPECT (contents_of (p.get_partition_view ())
+                == contents { { 11, 13, 2, 4 }, { 3, 6 }, { 9, 8, 10, 12 } });
+
+  vector_partition<int, 3> q (std::piecewise_construct, r2, r1, r0);
+  ok &= EXPECT (contents_of (q.get_partition_view ()) == contents { { 8, 10, 12 }, { 6 }, { 2, 4 } });
+
+  // the old elements are moved out and back
+  using movable = vector_partition<fragile<true>, 3>;
+  const std::vector<fragile<true>> m0 { 2, 4 };
+  const std::vector<fragile<true>> m1 { 6 };
+  ok &= expect_rollback ([] { return movable (std::piecewise_construct,
+                                              std::vector<fragile<true>> { 1 },
+                                              std::vector<fragile<true>> { },
+                                              std::vector<fragile<true>> { 3, 5 }); },
+                         [&] (movable& x) { x.insert_many (m0, m1, m0); }, __LINE__);
+
+  // the old elements are copied and left alone
+  using copied = vector_partition<fragile<false>, 3>;
+  const std::vector<fragile<false>> c0 { 2, 4 };
+  ok &= expect_rollback ([] { return copied (std::piecewise_construct,
+                                             std::vector<fragile<false>> { 1 },
+                                             std::vector<fragile<false>> { 3 },
+                                             std::vector<fragile<false>> { 5 }); },
+                         [&] (copied& x) { x.insert_many (c0, c0, c0); }, __LINE__);
+  return ok;
+}
+
+static
+bool
+do_test_reserve_layout (void)
+{
+  bool ok = true;
+  vector_partition<int, 2> p (std::piecewise_construct, std::vector<int> { 1 },
+                              std::vector<int> { 2 });
+  p.reserve_layout ({ { 2, 1 } });
+  ok &= EXPECT (contents_of (p.get_partition_view ()) == contents { { 1, 0, 0 }, { 2, 0 } });
+
+  // default construction may throw, so the layout is rebuilt in a new buffer
+  using fragile_partition = vector_partition<fragile<true>, 2>;
+  ok &= expect_rollback ([] { return fragile_partition (std::piecewise_construct,
+                                                        std::vector<fragile<true>> { 1, 2 },
+                                                        std::vector<fragile<true>> { 3 }); },
+                         [] (fragile_partition& x) { x.reserve_layout ({ { 2, 2 } }); },
+                         __LINE__);
+  return ok;
+}
+
+static
+bool
+do_test_erase_if (void)
+{
+  bool ok = true;
+  vector_partition<int, 3> p (std::piecewise_construct, std::vector<int> { 11, 13, 2, 4 },
+                              std::vector<int> { 3, 6 }, std::vector<int> { 9, 8, 10, 12 });
+  ok &= EXPECT (erase_if (p, [] (int x) { return x % 4 == 0; }) == 3);
+  ok &= EXPECT (contents_of (p.get_partition_view ()) == contents { { 11, 13, 2 }, { 3, 6 }, { 9, 10 } });
+
+  ok &= EXPECT (erase_if_indexed (p, [] (int x, std::size_t i) { return x > 10 && i != 1; }) == 2);
+  ok &= EXPECT (contents_of (p.get_partition_view ()) == contents { { 2 }, { 3, 6 }, { 9, 10 } });
+  return ok;
+}
+
+static
+bool
+do_test_promote_demote (void)
+{
+  bool ok = true;
+  vector_partition<int, 3> p (std::piecewise_construct, std::vector<int> { 2 },
+                              std::vector<int> { 3, 6 }, std::vector<int> { 9, 10 });
+  promote_if (get_subrange<1> (p), [] (int x) { return x == 3; });
+  ok &= EXPECT (sorted_contents_of (p.get_partition_view ()) == contents { { 2 }, { 6 }, { 3, 9, 10 } });
+
+  demote_if (get_subrange<2> (p), [] (int x) { return x != 3; });
+  ok &= EXPECT (sorted_contents_of (p.get_partition_view ()) == contents { { 2 }, { 6, 9, 10 }, { 3 } });
+  return ok;
+}
+
+static
+bool
+do_test_set_boundaries (void)
+{
+  bool ok = true;
+  vector_partition<int, 3> p (std::vector<int> { 2, 6, 9, 10, 3 }, { { 1, 3, 1 } });
+  p.set_boundaries ({ { 0, 3, 2 } });
+  ok &= EXPECT (contents_of (p.get_partition_view ()) == contents { { }, { 2, 6, 9 }, { 10, 3 } });
+
+  bool thrown = false;
+  try
+  {
+    p.set_boundaries ({ { 1, 1, 1 } });
+  }
+  catch (const std::invalid_argument&)
+  {
+    thrown = true;
+  }
+  ok &= EXPECT (thrown);
+  ok &= EXPECT (contents_of (p.get_partition_view ()) == contents { { }, { 2, 6, 9 }, { 10, 3 } });
+
+  list_partition<int, 3> l;
+  get_subrange<0> (l).assign (p.data_begin (), p.data_end ());
+  const int sizes[] = { 3, 1, 1 };
+  l.set_boundaries (std::begin (sizes), std::end (sizes));
+  ok &= EXPECT (contents_of (l.get_partition_view ()) == contents { { 2, 6, 9 }, { 10 }, { 3 } });
+  return ok;
+}
+
+static
+list_partition<int, 3>
+make_list_partition (void)
+{
+  list_partition<int, 3> l;
+  get_subrange<0> (l).assign ({ 2, 6, 9 });
+  get_subrange<1> (l).assign ({ 10 });
+  get_subrange<2> (l).assign ({ 3 });
+  return l;
+}
+
+static
+bool
+do_test_list_splice (void)
+{
+  bool ok = true;
+  list_partition<int, 3> l = make_list_partition ();
+  get_subrange<1> (l).splice (get_subrange<1> (l).end (), get_subrange<0> (l),
+                              get_subrange<0> (l).begin ());
+  ok &= EXPECT (contents_of (l.get_partition_view ()) == contents { { 6, 9 }, { 10, 2 }, { 3 } });
+
+  // an empty range, and an empty subrange of another partition
+  get_subrange<2> (l).splice (get_subrange<2> (l).begin (), get_subrange<1> (l),
+                              get_subrange<1> (l).begin (), get_subrange<1> (l).begin ());
+  list_partition<int, 3> none;
+  get_subrange<1> (l).splice (get_subrange<1> (l).end (), get_subrange<0> (none));
+  ok &= EXPECT (contents_of (l.get_partition_view ()) == contents { { 6, 9 }, { 10, 2 }, { 3 } });
+  ok &= EXPECT (contents_of (none.get_partition_view ()) == contents { { }, { }, { } });
+  return ok;
+}
+
+static
+bool
+do_test_list_advance (void)
+{
+  bool ok = true;
+  const list_partition<int, 3> l = make_list_partition ();
+  list_partition<int, 3> lc (l);
+  lc.advance_begin<2> (-2);
+  ok &= EXPECT (get_subrange<0> (lc).size () == 2);
+  ok &= EXPECT (get_subrange<1> (lc).size () == 0);
+  ok &= EXPECT (get_subrange<2> (lc).size () == 3);
+  ok &= EXPECT (contents_of (lc.get_partition_view ()) == contents { { 2, 6 }, { }, { 9, 10, 3 } });
+
+  bool thrown = false;
+  try
+  {
+    lc.advance_begin<2> (-10);
+  }
+  catch (const std::out_of_range&)
+  {
+    thrown = true;
+  }
+  ok &= EXPECT (thrown);
+
+  lc = l;
+  ok &= EXPECT (contents_of (lc.get_partition_view ()) == contents { { 2, 6, 9 }, { 10 }, { 3 } });
+
+  const auto moved = static_cast<std::ptrdiff_t> (get_subrange<1> (lc).size ());
+  lc.advance_begin_unchecked<2> (-moved);
+  lc.advance_end_unchecked<0> (moved + 1);
+  ok &= EXPECT (contents_of (lc.get_partition_view ()) == contents { { 2, 6, 9, 10, 3 }, { }, { } });
+  return ok;
+}
+
+static
+bool
+do_test_defragment (void)
+{
+  bool ok = true;
+  using pooled_partition = list_partition<int, 3, std::list<int, pool_alloc<int>>>;
+  pooled_partition pl;
+  get_subrange<0> (pl).assign ({ 2, 6, 9, 10, 3 });
+  const int sizes[] = { 3, 1, 1 };
+  pl.set_boundaries (std::begin (sizes), std::end (sizes));
+  pooled_partition plc (pl);
+  get_subrange<2> (plc).splice (get_subrange<2> (plc).end (), get_subrange<0> (pl));
+  ok &= EXPECT (contents_of (pl.get_partition_view ()) == contents { { }, { 10 }, { 3 } });
+  ok &= EXPECT (contents_of (plc.get_partition_view ()) == contents { { 2, 6, 9 }, { 10 }, { 3, 2, 6, 9 } });
+
+  get_subrange<1> (pl).defragment ();
+  get_subrange<2> (plc).defragment ();
+  plc.defragment ();
+  ok &= EXPECT (contents_of (pl.get_partition_view ()) == contents { { }, { 10 }, { 3 } });
+  ok &= EXPECT (contents_of (plc.get_partition_view ()) == contents { { 2, 6, 9 }, { 10 }, { 3, 2, 6, 9 } });
+
+  // moves may throw, so the elements are copied and the originals kept until the end
+  using fragile_list = list_partition<fragile<false>, 2>;
+  const auto make = [] (void)
+                    {
+                      fragile_list f;
+                      get_subrange<0> (f).assign ({ 1, 2, 3 });
+                      get_subrange<1> (f).assign ({ 4, 5 });
+                      return f;
+                    };
+  ok &= expect_rollback (make, [] (fragile_list& f) { f.defragment (); }, __LINE__);
+  ok &= expect_rollback (make, [] (fragile_list& f) { get_subrange<1> (f).defragment (); },
+                         __LINE__);
+  return ok;
+}
+
+static
+bool
+do_test_gap_relayout (void)
+{
+  using fragile_gap = gap_vector_partition<fragile<true>, 2>;
+  return expect_rollback ([] (void)
+                          {
+                            fragile_gap g;
+                            get_subrange<0> (g).push_back (1);
+                            get_subrange<1> (g).push_back (2);
+                            get_subrange<1> (g).push_back (3);
+                            return g;
+                          },
+                          [] (fragile_gap& g) { g.reserve (64); }, __LINE__);
+}
+
+static
+bool
+do_test_repartition (void)
+{
+  bool ok = true;
+  vector_partition<int, 3> r (std::piecewise_construct, std::vector<int> { 5, 1, 4 },
+                              std::vector<int> { 9, 2, 6 }, std::vector<int> { 3, 8, 7 });
+  stable_repartition (r, [] (int x) { return static_cast<std::size_t> (x % 3); });
+  ok &= EXPECT (contents_of (r.get_partition_view ()) == contents { { 9, 6, 3 }, { 1, 4, 7 }, { 5, 2, 8 } });
+
+  repartition (r, [] (int x) { return x < 5 ? std::size_t { 0 } : std::size_t { 2 }; });
+  ok &= EXPECT (sorted_contents_of (r.get_partition_view ())
+                == contents { { 1, 2, 3, 4 }, { }, { 5, 6, 7, 8, 9 } });
+  return ok;
+}
+
+static
+bool
+do_test_dynamic_vector_partition (void)
+{
+  bool ok = true;
+  dynamic_vector_partition<int> p (2);
+  p[0].push_back (1);
+  p[0].push_back (3);
+  p[1].insert (p[1].end (), { 5, 7, 9 });
+  ok &= EXPECT (contents_of (p.get_partition_view ()) == contents { { 1, 3 }, { 5, 7, 9 } });
+
+  p.split_subrange (1, std::next (p[1].begin ()));
+  p.push_back_subrange ().emplace_back (11);
+  ok &= EXPECT (contents_of (p.get_partition_view ()) == contents { { 1, 3 }, { 5 }, { 7, 9 }, { 11 } });
+  ok &= EXPECT (p.find_subrange (std::prev (p.data_end (), 2)) == 2);
+
+  p.merge_subranges (0, 1);
+  p.insert_subrange (0).push_back (-1);
+  ok &= EXPECT (contents_of (p.get_partition_view ()) == contents { { -1 }, { 1, 3, 5 }, { 7, 9 }, { 11 } });
+
+  p.advance_end (0, 2);
+  p.erase_subrange (2);
+  ok &= EXPECT (contents_of (p.get_partition_view ()) == contents { { -1, 1, 3 }, { 5 }, { 11 } });
+
+  dynamic_vector_partition<int> none;
+  ok &= EXPECT (none.find_subrange (none.data_end ()) == 0);
+
+  bool thrown = false;
+  try
+  {
+    dynamic_vector_partition<int> other (2);
+    p[0].transfer (p[0].begin (), other[1]);
+  }
+  catch (const std::invalid_argument&)
+  {
+    thrown = true;
+  }
+  ok &= EXPECT (thrown);
+  ok &= EXPECT (contents_of (p.get_partition_view ()) == contents { { -1, 1, 3 }, { 5 }, { 11 } });
+  return ok;
+}
+
+static
+bool
+do_test_indexed_list_partition (void)
+{
+  bool ok = true;
+  indexed_list_partition<int, 3> p;
+  p[0].insert (p[0].end (), { 1, 3, 5 });
+  p[1].insert (p[1].end (), { 7, 9 });
+  p[2].push_back (11);
+  ok &= EXPECT (contents_of (p.get_partition_view ()) == contents { { 1, 3, 5 }, { 7, 9 }, { 11 } });
+  ok &= EXPECT (*p[1].nth (1) == 9);
+  ok &= EXPECT (p[0].index_of (p.data_nth (2)) == 2);
+  ok &= EXPECT (p.find_subrange (p.data_nth (4)) == 1);
+
+  p[2].splice (p[2].begin (), p[0], p[0].nth (1), p[0].end ());
+  p.advance_begin (1, 1);
+  ok &= EXPECT (contents_of (p.get_partition_view ()) == contents { { 1, 7 }, { 9 }, { 3, 5, 11 } });
+
+  p[1].resize (4, -1);
+  p.advance_end (1, -5);
+  ok &= EXPECT (contents_of (p.get_partition_view ())
+                == contents { { 1 }, { }, { 7, 9, -1, -1, -1, 3, 5, 11 } });
+
+  // the ranges directly follow `pos`, so only the boundaries move
+  indexed_list_partition<int, 3> q;
+  q[1].insert (q[1].end (), { 2, 4, 6 });
+  q[2].push_back (8);
+  q[0].splice (q[0].cend (), q[1], q[1].cbegin (), std::next (q[1].cbegin ()));
+  q[1].splice (q[1].cend (), q[2], q[2].cbegin ());
+  ok &= EXPECT (contents_of (q.get_partition_view ()) == contents { { 2 }, { 4, 6, 8 }, { } });
+
+  // between partitions, the indices of both sides are rebuilt
+  p[1].splice (p[1].begin (), q[1], q[1].nth (1), q[1].end ());
+  ok &= EXPECT (contents_of (p.get_partition_view ())
+                == contents { { 1 }, { 6, 8 }, { 7, 9, -1, -1, -1, 3, 5, 11 } });
+  ok &= EXPECT (contents_of (q.get_partition_view ()) == contents { { 2 }, { 4 }, { } });
+  ok &= EXPECT (*p[1].nth (1) == 8);
+  ok &= EXPECT (*p[2].nth (0) == 7);
+  ok &= EXPECT (p.find_subrange (p.data_nth (2)) == 1);
+  ok &= EXPECT (q[1].size () == 1);
+  return ok;
+}
+
+static
+bool
+do_test_make_vector_partition (void)
+{
+  bool ok = true;
+  std::vector<int> v (20);
+  std::iota (v.begin (), v.end (), 0);
+  thread_pool pool (3);
+  auto p = make_vector_partition<3> (v.begin (), v.end (),
+                                     [] (int x) { return static_cast<std::size_t> (x % 3); }, pool);
+  ok &= EXPECT (contents_of (p.get_partition_view ())
+                == contents { { 0, 3, 6, 9, 12, 15, 18 },
+                              { 1, 4, 7, 10, 13, 16, 19 },
+                              { 2, 5, 8, 11, 14, 17 } });
+
+  auto e = make_vector_partition<3> (v.begin (), v.begin (),
+                                     [] (int) { return std::size_t { 0 }; }, pool);
+  ok &= EXPECT (contents_of (e.get_partition_view ()) == contents { { }, { }, { } });
+  return ok;
+}
+
+static
+bool
+do_test_parallel_algorithms (void)
+{
+  bool ok = true;
+  thread_pool pool (3);
+  vector_partition<int, 3> p (std::piecewise_construct,
+                              std::vector<int> { 0, 3, 6, 9, 12, 15, 18 },
+                              std::vector<int> { 1, 4, 7, 10, 13, 16, 19 },
+                              std::vector<int> { 2, 5, 8, 11, 14, 17 });
+  parallel::sort_subranges (p, std::greater<int> (), pool);
+  ok &= EXPECT (contents_of (p.get_partition_view ())
+                == contents { { 18, 15, 12, 9, 6, 3, 0 },
+                              { 19, 16, 13, 10, 7, 4, 1 },
+                              { 17, 14, 11, 8, 5, 2 } });
+
+  parallel::transform_subranges (p, [] (int x) { return x * 2; }, pool);
+  ok &= EXPECT (parallel::reduce_subranges (p, 0, std::plus<int> (), pool)
+                == std::vector<int> { 126, 140, 114 });
+
+  list_partition<int, 3> l;
+  get_subrange<0> (l).assign ({ 5, 1, 3 });
+  get_subrange<2> (l).assign ({ 9, 7, 8 });
+  parallel::sort_subranges (l, pool);
+  ok &= EXPECT (contents_of (l.get_partition_view ()) == contents { { 1, 3, 5 }, { }, { 7, 8, 9 } });
+
+  std::atomic<std::size_t> total { 0 };
+  parallel::for_each_subrange (l.get_partition_view (),
+                               [&total] (subrange_view<list_partition<int, 3>::data_iter>& sv)
+                               {
+                                 total += sv.size ();
+                               }, pool);
+  ok &= EXPECT (total == 6);
+
+  vector_partition<int, 3> skewed (std::piecewise_construct, std::vector<int> (5000, 1),
+                                   std::vector<int> (), std::vector<int> (3, 2));
+  std::array<std::atomic<int>, 3> sums { };
+  parallel::for_each (skewed, [&sums] (int x, std::size_t i) { sums[i] += x; }, pool);
+  ok &= EXPECT (sums[0] == 5000 && sums[1] == 0 && sums[2] == 6);
+
+  ok &= EXPECT (parallel::transform_reduce (skewed, 0, std::plus<int> (),
+                                            [] (int x, std::size_t i)
+                                            {
+                                              return x * static_cast<int> (i);
+                                            }, pool) == 12);
+  return ok;
+}
+
+static
+bool
+do_test_work_stealing_scheduler (void)
+{
+  bool ok = true;
+  std::atomic<int> done { 0 };
+  {
+    work_stealing_scheduler<> scheduler (4);
+    for (int i = 0; i < 100; ++i)
+    {
+      scheduler.submit ([&]
+                        {
+                          for (int j = 0; j < 3; ++j)
+                            scheduler.submit ([&done] () noexcept { ++done; });
+                        });
+    }
+    scheduler.wait ();
+    ok &= EXPECT (done == 300);
+
+    // only the first exception is rethrown, and the rest of the tasks still run
+    for (int i = 0; i < 8; ++i)
+      scheduler.submit ([&done] { ++done; throw std::runtime_error ("task failed"); });
+
+    bool thrown = false;
+    try
+    {
+      scheduler.wait ();
+    }
+    catch (const std::runtime_error&)
+    {
+      thrown = true;
+    }
+    ok &= EXPECT (thrown);
+    ok &= EXPECT (done == 308);
+
+    // the destructor waits for whatever is still queued
+    for (int i = 0; i < 50; ++i)
+      scheduler.submit ([&done] () noexcept { ++done; });
+  }
+  ok &= EXPECT (done == 358);
+  return ok;
+}
+
+static
+bool
+do_test_concurrent_fill (void)
+{
+  bool ok = true;
+  thread_pool pool (3);
+  vector_partition<int, 2> filled (std::piecewise_construct, std::vector<int> { -1 },
+                                   std::vector<int> { -2 });
+  {
+    concurrent_fill<int, 2> fill (filled, { { 4, 2 } });
+    pool.parallel_for (6,
+                       [&fill] (std::size_t i)
+                       {
+                         fill.writer (i % 3 == 0 ? 1 : 0).push (static_cast<int> (i));
+                       });
+    fill.commit ();
+
+    bool overflowed = false;
+    try
+    {
+      fill.writer (1).push (6);
+    }
+    catch (const std::out_of_range&)
+    {
+      overflowed = true;
+    }
+    ok &= EXPECT (overflowed);
+  }
+  ok &= EXPECT (sorted_contents_of (filled.get_partition_view ())
+                == contents { { -1, 1, 2, 4, 5 }, { -2, 0, 3 } });
+
+  concurrent_fill<int, 2> partial (filled, { { 1, 0 } });
+  bool thrown = false;
+  try
+  {
+    partial.commit ();
+  }
+  catch (const std::logic_error&)
+  {
+    thrown = true;
+  }
+  ok &= EXPECT (thrown);
+
+  partial.writer (0).push (7);
+  partial.commit ();
+  ok &= EXPECT (sorted_contents_of (filled.get_partition_view ())
+                == contents { { -1, 1, 2, 4, 5, 7 }, { -2, 0, 3 } });
+  return ok;
+}
+
+static
+bool
+do_test_partition_collector (void)
+{
+  bool ok = true;
+  thread_pool pool (3);
+  vector_partition<int, 2> filled (std::piecewise_construct, std::vector<int> { -1 },
+                                   std::vector<int> { -2 });
+  partition_collector<vector_partition<int, 2>> collector (filled);
+  pool.parallel_for (4,
+                     [&collector] (std::size_t i)
+                     {
+                       auto& local = collector.local ();
+                       local.push_back (i % 2, static_cast<int> (i));
+                       local.emplace_back (0, 100);
+                     });
+  collector.collect (pool);
+  ok &= EXPECT (sorted_contents_of (filled.get_partition_view ())
+                == contents { { -1, 0, 2, 100, 100, 100, 100 }, { -2, 1, 3 } });
+  return ok;
+}
+
+static
+bool
+do_test_synchronized_partition (void)
+{
+  bool ok = true;
+  thread_pool pool (3);
+  using sync_type = synchronized_partition<list_partition<int, 3>>;
+  sync_type sync;
+  sync.modify ([] (list_partition<int, 3>& lp)
+               {
+                 get_subrange<0> (lp).assign ({ 1, 2, 3 });
+                 get_subrange<2> (lp).assign ({ 4, 5 });
+               });
+  pool.parallel_for (100,
+                     [&sync] (std::size_t)
+                     {
+                       sync.write<0> ([] (sync_type::view_type<0> sub)
+                                      {
+                                        for (int& x : sub)
+                                          ++x;
+                                      });
+                       sync.emplace_back<2> (6);
+                       sync.mutate<2> ([] (list_partition<int, 3>::subrange_type<2>& sub)
+                                       {
+                                         sub.pop_back ();
+                                       });
+                       sync.read<2> ([] (const list_partition<int, 3>::subrange_type<2>& sub)
+                                     {
+                                       return sub.size ();
+                                     });
+                     });
+  sync.splice<1, 0> ();
+  sync.swap<1, 2> ();
+  sync.advance_begin<2> (1);
+  sync.read_all ([&ok] (const list_partition<int, 3>& lp)
+                 {
+                   ok &= EXPECT (contents_of (lp.get_partition_view ())
+                                 == contents { { }, { 4, 5, 101 }, { 102, 103 } });
+                 });
+  return ok;
+}
+
+static
+bool
+do_test_seqlock_partition (void)
+{
+  bool ok = true;
+  thread_pool pool (3);
+  seqlock_partition<vector_partition<int, 3>> seq (
+    vector_partition<int, 3> (std::vector<int> { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }, { { 3, 3, 4 } }));
+  std::atomic<std::size_t> torn_reads (0);
+  pool.parallel_for (2,
+                     [&seq, &torn_reads] (std::size_t i)
+                     {
+                       for (int j = 0; j < 1000; ++j)
+                       {
+                         if (i == 0)
+                           seq.advance_end<0> ((j % 2 == 0) ? 1 : -1);
+                         else
+                         {
+                           auto view = seq.get_partition_view ();
+                           if (view[0].size () + view[1].size () != 6 || view[2].size () != 4)
+                             ++torn_reads;
+                         }
+                       }
+                     });
+  ok &= EXPECT (torn_reads == 0);
+  ok &= EXPECT (contents_of (seq.get_partition_view ())
+                == contents { { 0, 1, 2 }, { 3, 4, 5 }, { 6, 7, 8, 9 } });
+  return ok;
+}
+
+static
+bool
+do_test_epoch_partition (void)
+{
+  bool ok = true;
+  thread_pool pool (3);
+  using session_table = list_partition<int, 2>;
+  session_table sessions;
+  get_subrange<0> (sessions).assign ({ 1, 2, 3, 4 });
+  epoch_partition<session_table> epoch (std::move (sessions));
+  std::atomic<std::size_t> bad_reads (0);
+  pool.parallel_for (4,
+                     [&epoch, &bad_reads] (std::size_t i)
+                     {
+                       for (int j = 0; j < 200; ++j)
+                       {
+                         if (i == 0)
+                         {
+                           epoch.update ([j] (session_table& table)
+                                         {
+                                           if (j % 2 == 0)
+                                             get_subrange<1> (table).splice (
+                                               get_subrange<1> (table).cend (),
+                                               get_subrange<0> (table),
+                                               get_subrange<0> (table).cbegin ());
+                                           else
+                                             get_subrange<0> (table).splice (
+                                               get_subrange<0> (table).cend (),
+                                               get_subrange<1> (table),
+                                               get_subrange<1> (table).cbegin ());
+                                         });
+                         }
+                         else
+                         {
+                           int sum = epoch.read ([] (const session_table& table)
+                                                 {
+                                                   int sum_of_ids = 0;
+                                                   for (int x : get_subrange<0> (table).view ())
+                                                     sum_of_ids += x;
+                                                   for (int x : get_subrange<1> (table).view ())
+                                                     sum_of_ids += x;
+                                                   return sum_of_ids;
+                                                 });
+                           if (sum != 10)
+                             ++bad_reads;
+                         }
+                       }
+                     });
+  ok &= EXPECT (bad_reads == 0);
+  ok &= EXPECT (epoch.reclaim () == 0);
+  epoch.read ([&ok] (const session_table& table)
+              {
+                ok &= EXPECT (contents_of (table.get_partition_view ()) == contents { { 1, 2, 3, 4 }, { } });
+              });
+  return ok;
+}
+
+static
+bool
+do_test_pool_alloc_threads (void)
+{
+  thread_pool pool (3);
+  // nodes allocated on this thread are freed by the workers
+  using pooled_table = list_partition<int, 2, std::list<int, pool_alloc<int>>>;
+  std::vector<pooled_table> tables (4);
+  for (pooled_table& table : tables)
+    get_subrange<0> (table).assign ({ 1, 2, 3, 4 });
+  pool.parallel_for (4,
+                     [&tables] (std::size_t i)
+                     {
+                       pooled_table& table = tables[i];
+                       for (int j = 0; j < 1000; ++j)
+                       {
+                         get_subrange<1> (table).push_back (j);
+                         get_subrange<0> (table).splice (get_subrange<0> (table).cend (),
+                                                         get_subrange<1> (table),
+                                                         get_subrange<1> (table).cbegin ());
+                         get_subrange<0> (table).pop_front ();
+                       }
+                     });
+  bool ok = true;
+  for (const pooled_table& table : tables)
+    ok &= EXPECT (contents_of (table.get_partition_view ()) == contents { { 996, 997, 998, 999 }, { } });
+  return ok;
+}
+
 static_assert (std::is_same<next_subrange_t<partition_subrange<list_partition<int, 5>, 3>, 1>,
                             partition_subrange<list_partition<int, 5>, 4>>::value,
                             "incorrect subrange type");
@@ -1200,11 +2125,44 @@ int main (void)
   }
   auto tv = clock::now ();
 
+  for (int i = 0; i < repeat; ++i)
+  {
+    do_test_partition<gap_vector_partition<int, 3>> ();
+  }
+  auto tg = clock::now ();
+
   std::cout << "list took:      " << std::chrono::duration_cast<std::chrono::milliseconds> (tl - ts).count () << " milliseconds." << std::endl;
   std::cout << "vector took:    " << std::chrono::duration_cast<std::chrono::milliseconds> (tv - ts).count () << " milliseconds." << std::endl;
+  std::cout << "gap took:       " << std::chrono::duration_cast<std::chrono::milliseconds> (tg - tv).count () << " milliseconds." << std::endl;
+
+  bool ok = true;
+  ok &= do_test_unordered_ops ();
+  ok &= do_test_transfer ();
+  ok &= do_test_subrange_swap ();
+  ok &= do_test_insert_many ();
+  ok &= do_test_reserve_layout ();
+  ok &= do_test_erase_if ();
+  ok &= do_test_promote_demote ();
+  ok &= do_test_set_boundaries ();
+  ok &= do_test_list_splice ();
+  ok &= do_test_list_advance ();
+  ok &= do_test_defragment ();
+  ok &= do_test_gap_relayout ();
+  ok &= do_test_repartition ();
+  ok &= do_test_dynamic_vector_partition ();
+  ok &= do_test_indexed_list_partition ();
+  ok &= do_test_make_vector_partition ();
+  ok &= do_test_parallel_algorithms ();
+  ok &= do_test_work_stealing_scheduler ();
+  ok &= do_test_concurrent_fill ();
+  ok &= do_test_partition_collector ();
+  ok &= do_test_synchronized_partition ();
+  ok &= do_test_seqlock_partition ();
+  ok &= do_test_epoch_partition ();
+  ok &= do_test_pool_alloc_threads ();
 
 #ifdef GCH_TEMPLATE_AUTO
   do_test_enum_access ();
 #endif
-  return 0;
+  return ok ? 0 : 1;
 }